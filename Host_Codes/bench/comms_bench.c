@@ -0,0 +1,402 @@
+/**
+ * \file        comms_bench.c
+ * \brief       Firmware deki haberleşme katmanını (Communication_Mechanism, UART_Frame, UART_Message),
+ *              MainController ı ve aktüatör controllerlarını Host_Codes/shim/posix üzerinde gerçek zamanda
+ *              çalıştırır ve bir pty veya SocketCAN hattı üzerinden yük altında ölçer.
+ *              Aynı process teki istemci threadi önce START, sonra CONTROL_REQ leri kayan bir pencereyle gönderir.
+ *              ACK_REP sadece son UART_ACK_WINDOW sıra numarasını kapsadığı için bir request, kendisinden
+ *              UART_ACK_WINDOW önceki request cevaplanmadan gönderilmez. Sayı yerine sıra numarası aralığı
+ *              sınırlanır, çünkü controllerda işlenen bir request cevaplanmadan sonrakiler mailbox ta
+ *              üzerine yazılıp cevaplanabilir. ACK_REP lerden her requestin gidiş-dönüş
+ *              süresi ve sonucu çıkarılır. Sonunda dolu bir pipeline ın arkasından STOP lar gönderilir ve
+ *              firmware in ölçtüğü en uzun STOP gecikmesi DIAG_STOP_LATENCY_MAX ile okunur.
+ *
+ *              Kullanım:
+ *                  ./comms_bench pty [count]
+ *                  ./comms_bench can <ifname> [count]
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  gcc -O2 -std=gnu11 -pthread -DUART_FRAME_SOFTWARE_CRC=1 -IHost_Codes/shim/posix \
+ *                      -IHost_Codes/shim/hal -IHost_Codes/transport -I$FW/Inc -I$FW/Src -I$FW/Src/Controllers \
+ *                      -I$FW/Src/Communications Host_Codes/bench/comms_bench.c Host_Codes/shim/posix/posix_rtos.c \
+ *                      Host_Codes/shim/hal/hal.c Host_Codes/transport/pty_transport.c \
+ *                      Host_Codes/transport/can_transport.c $FW/Src/Communications/Communication_Mechanism.c \
+ *                      $FW/Src/Communications/UART_Frame.c $FW/Src/Communications/UART_Message.c \
+ *                      $FW/Src/Communications/Flight_Recorder.c $FW/Src/Communications/Telemetry_Codec.c \
+ *                      $FW/Src/Controllers/MainController.c $FW/Src/Controllers/BrakeController.c \
+ *                      $FW/Src/Controllers/ThrottleController.c $FW/Src/Controllers/SteerController.c \
+ *                      $FW/Src/Controllers/HeartbeatSupervisor.c $FW/Src/helpers.c -o comms_bench
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "main.h"
+#include "cmsis_os.h"
+#include "BrakeController.h"
+#include "ThrottleController.h"
+#include "SteerController.h"
+#include "MainController.h"
+#include "Communication_Mechanism.h"
+#include "UART_Frame.h"
+#include "Sensors/hcsr04.h"
+#include "pty_transport.h"
+#include "can_transport.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define BENCH_DEFAULT_COUNT (10000)
+#define BENCH_ACK_TIMEOUT_NS (1000000000ULL)     //bu sürede ACK gelmeyen request kayıp sayılır
+#define BENCH_SEQ_COUNT (256)
+#define BENCH_STOP_COUNT (100)     //ölçüm sonunda CONTROL_REQ lerin arkasından gönderilen STOP sayısı
+/*------------------------------< Typedefs >----------------------------------*/
+struct BENCH_PENDING
+{
+    uint64_t sent_ns;
+    uint8_t waiting;
+};
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+static int client_fd = -1;
+static uint8_t client_is_can;
+static uart_frame_parser client_parser;
+
+static struct BENCH_PENDING pending[BENCH_SEQ_COUNT];
+static uint32_t in_flight;
+static uint64_t* rtt_ns;
+static uint32_t rtt_count;
+static uint32_t results[4];     //ACK_RESULT e göre
+static uint32_t lost_count;
+/*------------------------------< Prototypes >--------------------------------*/
+static int bench_open_client (const char* ifname);
+static void bench_write (const uint8_t* data, uint8_t len);
+static uint16_t bench_read (uint8_t* buf, uint16_t max_len, int timeout_ms);
+static void bench_send (const uint8_t* payload, uint8_t len, uint8_t seq);
+static void bench_send_startstop (uint8_t val, uint8_t seq);
+static void bench_measure_stop (uint8_t seq);
+static void bench_poll (int timeout_ms);
+static void bench_on_ack (const uart_rep* rep);
+static void bench_expire (uint64_t now);
+static uint64_t bench_now_ns ( );
+static int bench_compare (const void* a, const void* b);
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    const transport* link = &pty_transport;
+    const char* ifname = NULL;
+    uint32_t count = BENCH_DEFAULT_COUNT;
+    uint32_t sent = 0;
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE] = { 0 };
+    uart_req* req = (uart_req*) payload;
+    uint64_t start;
+    uint64_t elapsed;
+    uint64_t rtt_sum = 0;
+    uint32_t i;
+
+    if (argc >= 2 && strcmp(argv[1], "pty") == 0)
+    {
+        count = (argc >= 3) ? strtoul(argv[2], NULL, 0) : count;
+    }
+    else if (argc >= 3 && strcmp(argv[1], "can") == 0)
+    {
+        ifname = argv[2];
+        count = (argc >= 4) ? strtoul(argv[3], NULL, 0) : count;
+        can_transport_configure(ifname, CAN_TRANSPORT_DEFAULT_RX_ID, CAN_TRANSPORT_DEFAULT_TX_ID);
+        link = &can_transport;
+    }
+    else
+    {
+        fprintf(stderr, "usage: %s pty [count]\n       %s can <ifname> [count]\n", argv[0], argv[0]);
+        return 2;
+    }
+    rtt_ns = calloc(count + UART_ACK_WINDOW, sizeof(uint64_t));
+
+    //main.c deki sıra, acil stop butonu basılı değil.
+    EMERGENCY_STOP_GPIO_Port->IDR |= EMERGENCY_STOP_Pin;
+    brake_init( );
+    throttle_set_value(SPEED_0);
+    throttle_set_lock(THROTTLE_LOCK);
+    steer_init( );
+    communication_init(link);
+    main_controller_init( );
+
+    if (bench_open_client(ifname) != 0)
+    {
+        fprintf(stderr, "client: %s\n", strerror(errno));
+        return 1;
+    }
+    uart_frame_parser_init(&client_parser);
+
+    bench_send_startstop(1, 0);
+    while (in_flight != 0)
+    {
+        bench_poll(100);
+    }
+    if (is_started != 1)
+    {
+        fprintf(stderr, "START was not accepted\n");
+        return 1;
+    }
+    rtt_count = 0;
+    memset(results, 0, sizeof(results));
+
+    start = bench_now_ns( );
+    while (sent < count || in_flight != 0)
+    {
+        if (sent < count && !pending[(uint8_t) (1 + sent - UART_ACK_WINDOW)].waiting)
+        {
+            memset(payload, 0, sizeof(payload));
+            req->control_packed.header = CONTROL_REQ;
+            req->control_packed.steer = (sent % 2) ? 100 : 0;
+            req->control_packed.throttle = CONTROL_THROTTLE_KEEP;
+            req->control_packed.brake = CONTROL_BRAKE_KEEP;
+            bench_send(payload, UART_CONTROL_REQ_SIZE, (uint8_t) (1 + sent));
+            ++sent;
+            bench_poll(0);
+        }
+        else
+        {
+            bench_poll(10);
+        }
+        bench_expire(bench_now_ns( ));
+    }
+    elapsed = bench_now_ns( ) - start;
+
+    qsort(rtt_ns, rtt_count, sizeof(uint64_t), bench_compare);
+    for (i = 0; i < rtt_count; ++i)
+    {
+        rtt_sum += rtt_ns[i];
+    }
+    printf("transport         : %s\n", ifname ? ifname : pty_transport_get_slave_name( ));
+    printf("requests          : %u sent, %u acked, %u lost\n", count, rtt_count, lost_count);
+    printf("results           : ok %u error %u unknown %u superseded %u\n", results[ACK_OK], results[ACK_ERROR],
+            results[ACK_UNKNOWN], results[ACK_SUPERSEDED]);
+    printf("throughput        : %.0f req/s\n", count / (elapsed / 1e9));
+    if (rtt_count != 0)
+    {
+        printf("rtt               : mean %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                rtt_sum / (double) rtt_count / 1e3, rtt_ns[rtt_count / 2] / 1e3,
+                rtt_ns[(uint32_t) (rtt_count * 0.99)] / 1e3, rtt_ns[rtt_count - 1] / 1e3);
+    }
+    bench_measure_stop((uint8_t) (1 + count));
+    printf("stop latency      : max %u us over %u STOPs (DIAG %u)\n", communication_get_diag(DIAG_STOP_LATENCY_MAX),
+            BENCH_STOP_COUNT, DIAG_STOP_LATENCY_MAX);
+    return lost_count != 0;
+}
+
+/*
+ * Sensör yerine geçen fonksiyon.
+ */
+
+uint16_t hcsr04_get_distance ( )
+{
+    return 0;
+}
+
+static int bench_open_client (const char* ifname)
+{
+    struct termios tio;
+
+    if (ifname != NULL)
+    {
+        client_is_can = 1;
+        client_fd = can_transport_open_socket(ifname, CAN_TRANSPORT_DEFAULT_TX_ID);
+        return (client_fd < 0) ? -1 : 0;
+    }
+    client_fd = open(pty_transport_get_slave_name( ), O_RDWR | O_NOCTTY);
+    if (client_fd < 0 || tcgetattr(client_fd, &tio) != 0)
+    {
+        return -1;
+    }
+    cfmakeraw(&tio);
+    return tcsetattr(client_fd, TCSANOW, &tio);
+}
+
+static void bench_write (const uint8_t* data, uint8_t len)
+{
+    if (!client_is_can)
+    {
+        if (write(client_fd, data, len) != len)
+        {
+            perror("write");
+        }
+        return;
+    }
+    if (can_transport_send(client_fd, CAN_TRANSPORT_DEFAULT_RX_ID, data, len) != OK)
+    {
+        perror("write");
+    }
+}
+
+static uint16_t bench_read (uint8_t* buf, uint16_t max_len, int timeout_ms)
+{
+    struct pollfd pfd = { client_fd, POLLIN, 0 };
+    struct can_frame frame;
+    ssize_t len;
+
+    if (poll(&pfd, 1, timeout_ms) <= 0)
+    {
+        return 0;
+    }
+    if (!client_is_can)
+    {
+        len = read(client_fd, buf, max_len);
+        return (len > 0) ? len : 0;
+    }
+    if (read(client_fd, &frame, sizeof(frame)) != sizeof(frame) || frame.can_dlc > max_len)
+    {
+        return 0;
+    }
+    memcpy(buf, frame.data, frame.can_dlc);
+    return frame.can_dlc;
+}
+
+static void bench_send (const uint8_t* payload, uint8_t len, uint8_t seq)
+{
+    uint8_t frame[UART_FRAME_MAX_SIZE];
+
+    if (pending[seq].waiting)
+    {
+        //sıra numarası döndü ve eski request hala cevapsız
+        --in_flight;
+        ++lost_count;
+    }
+    pending[seq].sent_ns = bench_now_ns( );
+    pending[seq].waiting = 1;
+    ++in_flight;
+    bench_write(frame, uart_frame_encode(payload, len, seq, frame));
+}
+
+static void bench_send_startstop (uint8_t val, uint8_t seq)
+{
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE] = { 0 };
+    uart_req* req = (uart_req*) payload;
+
+    req->req_packed.header = START_STOP_REQ;
+    req->req_packed.data = val;
+    bench_send(payload, UART_REQ_SIZE, seq);
+}
+
+/**
+ * Her turda araç başlatılır, ardından UART_ACK_WINDOW - 2 CONTROL_REQ ve bir STOP arka arkaya gönderilir.
+ * STOP controller ın ve queue ların dolu olduğu anda gelir. Gecikmeyi firmware ölçer, DIAG ile okunur.
+ * */
+static void bench_measure_stop (uint8_t seq)
+{
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE] = { 0 };
+    uart_req* req = (uart_req*) payload;
+    uint32_t round;
+    uint8_t i;
+
+    for (round = 0; round < BENCH_STOP_COUNT; ++round)
+    {
+        bench_send_startstop(1, seq++);
+        for (i = 0; i < UART_ACK_WINDOW - 2; ++i)
+        {
+            req->control_packed.header = CONTROL_REQ;
+            req->control_packed.steer = (i % 2) ? 100 : 0;
+            req->control_packed.throttle = 5;
+            req->control_packed.brake = CONTROL_BRAKE_KEEP;
+            bench_send(payload, UART_CONTROL_REQ_SIZE, seq++);
+        }
+        bench_send_startstop(0, seq++);
+        while (in_flight != 0)
+        {
+            rtt_count = 0;     //sadece sonuçların gelmesi beklenir
+            bench_poll(10);
+            bench_expire(bench_now_ns( ));
+        }
+    }
+}
+
+/**
+ * Gelen byte ları parsera verir, ACK_REP dışındaki cevaplar (CONTROL_REP) atlanır.
+ * */
+static void bench_poll (int timeout_ms)
+{
+    uint8_t chunk[64];
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE];
+    uint8_t payload_len;
+    uint8_t seq;
+    uint16_t len = bench_read(chunk, sizeof(chunk), timeout_ms);
+    uint16_t i;
+    Return_Status status;
+
+    for (i = 0; i < len; ++i)
+    {
+        for (status = uart_frame_parse_byte(&client_parser, chunk[i], payload, &payload_len, &seq); status == OK;
+                status = uart_frame_parse_next(&client_parser, payload, &payload_len, &seq))
+        {
+            if (payload[0] == ACK_REP && payload_len == UART_ACK_REP_SIZE)
+            {
+                bench_on_ack((const uart_rep*) payload);
+            }
+        }
+    }
+}
+
+/**
+ * ACK_REP son UART_ACK_WINDOW sıra numarasını kapsar. Bekleyen her numara için RTT kaydedilir,
+ * aynı numara sonraki ACK_REP lerde tekrar gelirse atlanır.
+ * */
+static void bench_on_ack (const uart_rep* rep)
+{
+    uint64_t now = bench_now_ns( );
+    uint8_t seq = rep->ack_packed.seq;
+    uint8_t i;
+
+    for (i = 0; i < UART_ACK_WINDOW; ++i)
+    {
+        uint8_t s = (uint8_t) (seq - i);
+
+        if ((rep->ack_packed.received & (1 << i)) == 0 || !pending[s].waiting)
+        {
+            continue;
+        }
+        pending[s].waiting = 0;
+        --in_flight;
+        rtt_ns[rtt_count++] = now - pending[s].sent_ns;
+        ++results[(rep->ack_packed.results >> (2 * i)) & 0x3];
+    }
+}
+
+static void bench_expire (uint64_t now)
+{
+    uint16_t s;
+
+    for (s = 0; s < BENCH_SEQ_COUNT; ++s)
+    {
+        if (pending[s].waiting && now - pending[s].sent_ns > BENCH_ACK_TIMEOUT_NS)
+        {
+            pending[s].waiting = 0;
+            --in_flight;
+            ++lost_count;
+        }
+    }
+}
+
+static uint64_t bench_now_ns ( )
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static int bench_compare (const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+
+    return (x > y) - (x < y);
+}
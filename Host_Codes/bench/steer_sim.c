@@ -0,0 +1,286 @@
+/**
+ * \file        steer_sim.c
+ * \brief       SteerController.c yi TIM2/TIM3 ün bir modeliyle sanal zamanda çalıştırır. Model:
+ *              TIM2 nin ARR ve CCR3 ü preload ludur, yazılan değer bir sonraki update te veya UG de aktif
+ *              olur. PWM2 de pulse CNT = CCR3 te yükselir, periyodun sonunda biter, CCR3 > ARR ise çıkmaz.
+ *              TIM3 TIM2 nin her update ini (UG dahil) sayar, CNT >= CCR1 iken TIM2 donar. CC1 kesmesi
+ *              rastgele gecikir, steer_set_value rastgele anlarda ve TIM2 kesmesinin içinden çağrılır.
+ *
+ *              Kontroller:
+ *                  - motor milinin konumu (DIR pinine göre sayılan pulse lar) her zaman steer_get_value ile aynıdır
+ *                  - adımlar arası hız değişimi bir adımlık ivmelenmeyi geçmez
+ *                  - her pulse DIR yazıldıktan en az STEERING_DIR_SETUP_TIME sonra yükselir
+ *                  - yön değişince eski yöndeki son pulse ile yeni yöndeki ilk pulse arasında en az bir
+ *                    STEERING_START_RATE periyodu vardır
+ *              Sonunda farklı uzunluktaki hareketlerin süreleri (yön değişimi ve dwell dahil) eski sabit hızla
+ *              karşılaştırılır.
+ *
+ *              Kullanım:
+ *                  ./steer_sim [trials]
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  gcc -O2 -std=gnu11 -IHost_Codes/shim/sim -IHost_Codes/shim/hal -I$FW/Inc -I$FW/Src \
+ *                      -I$FW/Src/Controllers Host_Codes/bench/steer_sim.c Host_Codes/shim/sim/sim_rtos.c \
+ *                      Host_Codes/shim/hal/hal.c -lm -o steer_sim
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "SteerController.c"     //static motion ve TIM2/TIM3 kesmeleri için
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define SIM_DEFAULT_TRIALS (2000)
+#define SIM_GATED_STEP (20e-6)     //s, TIM2 donukken CC1 kesmesine bakma aralığı
+#define SIM_CC1_LATENCY_ODDS (4)     //CC1 kesmesi her bakışta 1/4 ihtimalle çalışır
+#define SIM_RETARGET_ODDS (50)     //TIM2 kesmesinin 1/50 sinde yeni değer gelir
+#define SIM_RATE_TOLERANCE (1.0)     //step/s, float yuvarlaması
+/*------------------------------< Typedefs >----------------------------------*/
+struct SIM_RESULT
+{
+    uint32_t pulses;
+    uint32_t reversals;
+    uint32_t position_errors;
+    uint32_t setup_errors;
+    uint32_t dwell_errors;
+    double max_rate_change;
+    double min_reversal_gap;
+};
+/*------------------------------< Variables >---------------------------------*/
+static uint32_t tim2_arr;     //TIM2 nin aktif (preload dan yüklenmiş) registerları
+static uint32_t tim2_ccr3;
+static double sim_time;
+static int32_t shaft;
+static int inject;
+static int dir_pin = -1;
+static double dir_time;
+static int last_dir;
+static double last_pulse_end = -1;
+static double last_rate;
+static struct SIM_RESULT result;
+/*------------------------------< Prototypes >--------------------------------*/
+static void sim_tim3_count ( );
+static void sim_watch_dir ( );
+static void sim_period ( );
+static void sim_step ( );
+static void sim_run_until (double until);
+static void sim_set_value (int value);
+static void sim_check_position (int trial);
+static void sim_profile ( );
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    int trials = (argc > 1) ? atoi(argv[1]) : SIM_DEFAULT_TRIALS;
+    double rate_limit = sqrt(STEER_RATE_SQ(STEERING_START_RATE) + 2.0 * STEERING_ACCELERATION) - STEERING_START_RATE;
+    int failed;
+
+    steer_init( );
+    srand(3);
+    result.min_reversal_gap = 1e9;
+    inject = 1;
+    for (int trial = 0; trial < trials; ++trial)
+    {
+        sim_set_value((rand( ) % 13601) - 6800);
+        sim_run_until(sim_time + ((rand( ) % 4 == 0) ? (rand( ) % 2000) / 1e3 : 0.02));     //çoğunlukla 50 Hz
+        sim_check_position(trial);
+    }
+    inject = 0;
+    sim_set_value(1234);
+    sim_run_until(sim_time + 10);
+    if (TIM2->CR1 & TIM_CR1_CEN)
+    {
+        printf("motor did not stop\n");
+        return 1;
+    }
+    sim_check_position(trials);
+
+    printf("trials %d, pulses %u, reversals %u, final shaft %d get %d\n", trials, result.pulses,
+        result.reversals, shaft, steer_get_value( ));
+    printf("max per-step change %.0f step/s (limit %.0f), min reversal gap %.1f us (dwell %.1f us, DIR setup %d us)\n",
+        result.max_rate_change, rate_limit, result.min_reversal_gap * 1e6, 1e6 / STEERING_START_RATE,
+        STEERING_DIR_SETUP_TIME);
+    printf("position errors %u, DIR setup errors %u, dwell errors %u\n", result.position_errors, result.setup_errors,
+        result.dwell_errors);
+    failed = result.position_errors || result.setup_errors || result.dwell_errors || shaft != 1234
+        || result.max_rate_change > rate_limit + SIM_RATE_TOLERANCE;
+    sim_profile( );
+    return failed;
+}
+
+/**
+ * UG preload u aktif registerlara yükler. TIM2 nin TRGO su update olduğu için TIM3 UG yi de sayar.
+ * */
+void shim_tim_event (TIM_TypeDef* tim, uint32_t event)
+{
+    if ((event & TIM_EGR_UG) == 0)
+    {
+        return;
+    }
+    tim->CNT = 0;
+    tim->SR |= TIM_SR_UIF;
+    if (tim == TIM2)
+    {
+        tim2_arr = TIM2->ARR;
+        tim2_ccr3 = TIM2->CCR3;
+        sim_tim3_count( );
+    }
+}
+
+static void sim_tim3_count ( )
+{
+    if (TIM3->CR1 & TIM_CR1_CEN)
+    {
+        ++TIM3->CNT;
+        if (TIM3->CNT == TIM3->CCR1)
+        {
+            TIM3->SR |= TIM_SR_CC1IF;
+        }
+    }
+}
+
+/**
+ * Firmware DIR ı sadece kesmelerde ve steer_set_value da yazar, her çağrıdan sonra bakılır.
+ * */
+static void sim_watch_dir ( )
+{
+    int dir = (STEER_DIR_GPIO_Port->ODR & STEER_DIR_Pin) ? -1 : 1;
+
+    if (dir != dir_pin)
+    {
+        dir_pin = dir;
+        dir_time = sim_time;
+    }
+}
+
+/**
+ * TIM2 nin aktif periyodu baştan sona çalışır, sonundaki update te preload yüklenir ve kesme çağrılır.
+ * */
+static void sim_period ( )
+{
+    double period = (tim2_arr + 1) / STEER_TIMER_CLOCK;
+
+    if (tim2_ccr3 <= tim2_arr)
+    {
+        double rise = sim_time + tim2_ccr3 / STEER_TIMER_CLOCK;
+        double rate = 1 / period;
+
+        if (rise - dir_time < STEERING_DIR_SETUP_TIME * 1e-6)
+        {
+            ++result.setup_errors;
+        }
+        if (last_pulse_end >= 0 && dir_pin != last_dir)
+        {
+            double gap = rise - last_pulse_end;
+
+            ++result.reversals;
+            if (gap < result.min_reversal_gap)
+            {
+                result.min_reversal_gap = gap;
+            }
+            if (gap < 1.0 / STEERING_START_RATE)
+            {
+                ++result.dwell_errors;
+            }
+        }
+        else if (last_rate > 0 && fabs(rate - last_rate) > result.max_rate_change)
+        {
+            result.max_rate_change = fabs(rate - last_rate);
+        }
+        shaft += dir_pin;
+        ++result.pulses;
+        last_dir = dir_pin;
+        last_rate = rate;
+        last_pulse_end = sim_time + period;
+    }
+    sim_time += period;
+
+    tim2_arr = TIM2->ARR;
+    tim2_ccr3 = TIM2->CCR3;
+    sim_tim3_count( );
+    TIM2->SR |= TIM_SR_UIF;
+    if (inject && rand( ) % SIM_RETARGET_ODDS == 0)
+    {
+        sim_set_value((rand( ) % 13601) - 6800);
+    }
+    steer_step_irq_handler( );
+    sim_watch_dir( );
+}
+
+static void sim_step ( )
+{
+    if ((TIM3->CR1 & TIM_CR1_CEN) && TIM3->CNT >= TIM3->CCR1)
+    {
+        sim_time += SIM_GATED_STEP;     //kapı kapalı, TIM2 donuk
+    }
+    else
+    {
+        sim_period( );
+    }
+    if ((TIM3->SR & TIM_SR_CC1IF) && rand( ) % SIM_CC1_LATENCY_ODDS == 0)
+    {
+        steer_count_irq_handler( );
+        sim_watch_dir( );
+    }
+}
+
+static void sim_run_until (double until)
+{
+    while (sim_time < until && (TIM2->CR1 & TIM_CR1_CEN))
+    {
+        sim_step( );
+    }
+    if (sim_time < until)
+    {
+        sim_time = until;
+    }
+}
+
+static void sim_set_value (int value)
+{
+    steer_set_value(value);
+    sim_watch_dir( );
+}
+
+/**
+ * Hareket sürerken TIM3 periyodun ortasında olabilir, konum adım sınırında karşılaştırılır.
+ * */
+static void sim_check_position (int trial)
+{
+    if (steer_get_value( ) != shaft)
+    {
+        if (++result.position_errors <= 5)
+        {
+            printf("trial %d: get %d shaft %d\n", trial, steer_get_value( ), shaft);
+        }
+    }
+}
+
+/**
+ * Her hareket bir öncekinin tersi yönündedir, süre steer_set_value dan motorun durmasına kadardır.
+ * */
+static void sim_profile ( )
+{
+    static const int32_t moves[] = { 15000, 7500, 1000, 100, 10, 2, 1 };
+    int32_t target = STEERING_MIN_VALUE;
+
+    sim_set_value(target);
+    sim_run_until(sim_time + 10);
+    for (uint32_t m = 0; m < sizeof(moves) / sizeof(moves[0]); ++m)
+    {
+        double start = sim_time;
+
+        target += (target < 0) ? moves[m] : -moves[m];
+        sim_set_value(target);
+        while (TIM2->CR1 & TIM_CR1_CEN)
+        {
+            sim_step( );
+        }
+        printf("%5d steps: %.4f s (constant %d step/s %.4f s), shaft %d\n", moves[m], sim_time - start,
+            STEERING_START_RATE, (double) moves[m] / STEERING_START_RATE, shaft);
+    }
+}
@@ -0,0 +1,303 @@
+/**
+ * \file        telemetry_bench.c
+ * \brief       Bir telemetri kaydını firmware deki Telemetry_Codec ile farklı batch değerleriyle kodlar ve
+ *              örnek başına hatta giden byte sayısını (çerçeve overhead i ve keyframeler dahil) yazar.
+ *              Kodlanan her çerçeve host decoder ı ile tekrar açılır ve orijinal snapshotlarla karşılaştırılır.
+ *              Çerçeveleme sırası Communication_Mechanism deki communication_send_telemetry_delta ile aynıdır.
+ *
+ *              Kayıt her satırı bir snapshot olan bir CSV dosyasıdır (ilk satır başlık olabilir):
+ *                  tick,time,steer,throttle,brake_current,brake_next,distance,rx_queue,tx_queue[,steer_target,steer_rate,steer_moving[,expired]]
+ *              VehicleClient::on_telemetry ile alınan snapshotlar bu formatta yazılabilir. Dosya verilmezse
+ *              200 Hz te 60 s lik bir slalom sürüşü üretilir.
+ *
+ *              Kullanım:
+ *                  ./telemetry_bench [trace.csv] [rate]
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  gcc -O2 -std=gnu11 -IHost_Codes/shim/posix -IHost_Codes/shim/hal -I$FW/Inc -I$FW/Src \
+ *                      -I$FW/Src/Communications Host_Codes/bench/telemetry_bench.c \
+ *                      $FW/Src/Communications/Telemetry_Codec.c -lm -o telemetry_bench
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "Telemetry_Codec.h"
+#include "UART_Frame.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define BENCH_DEFAULT_RATE (200)     //Hz, üretilen sürüş ve link kullanımı için
+#define BENCH_SYNTHETIC_SECONDS (60)
+#define BENCH_LINK_BAUDRATE (115200)
+#define BENCH_BITS_PER_BYTE (10)     //start ve stop bitleri dahil
+/*------------------------------< Typedefs >----------------------------------*/
+struct BENCH_RESULT
+{
+    uint64_t bytes;
+    uint32_t frames;
+    uint32_t keyframes;
+    uint32_t decoded;
+    uint32_t mismatches;
+};
+/*------------------------------< Constants >---------------------------------*/
+static const uint8_t batches[] = { 0, 1, 2, 4, 8, 16 };
+/*------------------------------< Variables >---------------------------------*/
+static uart_rep* trace;
+static uint32_t trace_count;
+static uint32_t random_state = 12345;
+/*------------------------------< Prototypes >--------------------------------*/
+static int bench_load (const char* path);
+static void bench_synthesize (uint16_t rate);
+static void bench_run (uint8_t batch, struct BENCH_RESULT* result);
+static void bench_emit (const uint8_t* payload, uint8_t size, telemetry_decoder* decoder, struct BENCH_RESULT* result);
+static void bench_follow (int16_t target, double seconds, double* position, double* rate);
+static int32_t bench_random (int32_t min, int32_t max);
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    uint16_t rate = (argc >= 3) ? strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_RATE;
+    double raw_bytes = UART_TELEMETRY_REP_SIZE + UART_FRAME_OVERHEAD;
+    uint32_t failed = 0;
+
+    if (argc >= 2)
+    {
+        if (bench_load(argv[1]) != 0)
+        {
+            fprintf(stderr, "%s: cannot read trace\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        bench_synthesize(rate);
+    }
+    printf("trace             : %s, %u samples, %u Hz\n", (argc >= 2) ? argv[1] : "synthetic slalom", trace_count,
+            rate);
+    printf("batch  bytes/sample  reduction  link@%u  keyframes  frames  latency  mismatches\n", BENCH_LINK_BAUDRATE);
+    for (uint32_t i = 0; i < sizeof(batches); ++i)
+    {
+        struct BENCH_RESULT result = { 0 };
+        double per_sample;
+
+        bench_run(batches[i], &result);
+        per_sample = (double) result.bytes / trace_count;
+        printf("%5u  %12.2f  %8.1fx  %6.1f%%  %9u  %6u  %5.1f ms  %10u\n", batches[i], per_sample,
+                raw_bytes / per_sample, 100.0 * per_sample * rate * BENCH_BITS_PER_BYTE / BENCH_LINK_BAUDRATE,
+                result.keyframes, result.frames, (batches[i] > 1) ? (batches[i] - 1) * 1000.0 / rate : 0.0,
+                result.mismatches + (trace_count - result.decoded));
+        failed += result.mismatches + (trace_count - result.decoded);
+    }
+    free(trace);
+    return failed != 0;
+}
+
+/**
+ * Her snapshot firmware deki gibi kodlanır. batch 0 sıkıştırmasız TELEMETRY_REP akışıdır.
+ * */
+static void bench_run (uint8_t batch, struct BENCH_RESULT* result)
+{
+    telemetry_encoder encoder;
+    telemetry_decoder decoder;
+    uint8_t payload[TELEMETRY_CODEC_MAX_SIZE];
+    uint8_t size;
+
+    telemetry_encoder_init(&encoder);
+    telemetry_decoder_init(&decoder);
+    for (uint32_t i = 0; i < trace_count; ++i)
+    {
+        uart_rep* snapshot = &trace[i];
+
+        if (batch == 0 || telemetry_encoder_is_keyframe_due(&encoder))
+        {
+            if ((size = telemetry_encoder_flush(&encoder, payload)) != 0)
+            {
+                bench_emit(payload, size, &decoder, result);
+            }
+            telemetry_encoder_keyframe(&encoder, snapshot);
+            bench_emit(snapshot->rep.msg, UART_TELEMETRY_REP_SIZE, &decoder, result);
+            ++result->keyframes;
+            continue;
+        }
+        if (telemetry_encoder_add(&encoder, snapshot) != OK)
+        {
+            size = telemetry_encoder_flush(&encoder, payload);
+            bench_emit(payload, size, &decoder, result);
+            telemetry_encoder_add(&encoder, snapshot);
+        }
+        if (encoder.count >= batch)
+        {
+            size = telemetry_encoder_flush(&encoder, payload);
+            bench_emit(payload, size, &decoder, result);
+        }
+    }
+    if ((size = telemetry_encoder_flush(&encoder, payload)) != 0)
+    {
+        bench_emit(payload, size, &decoder, result);
+    }
+}
+
+/**
+ * Çerçeve hatta gitmiş gibi sayılır ve VehicleClient teki gibi açılır. Snapshotlar sırayla geldiği için
+ * result->decoded aynı zamanda karşılaştırılacak kayıt indexidir.
+ * */
+static void bench_emit (const uint8_t* payload, uint8_t size, telemetry_decoder* decoder, struct BENCH_RESULT* result)
+{
+    uart_rep snapshots[TELEMETRY_CODEC_MAX_SAMPLES];
+    uint8_t count;
+
+    result->bytes += size + UART_FRAME_OVERHEAD;
+    ++result->frames;
+    if (payload[0] == TELEMETRY_REP)
+    {
+        memcpy(snapshots[0].rep.msg, payload, UART_TELEMETRY_REP_SIZE);
+        telemetry_decoder_keyframe(decoder, &snapshots[0]);
+        count = 1;
+    }
+    else
+    {
+        count = telemetry_decoder_decode(decoder, payload, size, snapshots, TELEMETRY_CODEC_MAX_SAMPLES);
+    }
+    for (uint8_t i = 0; i < count && result->decoded < trace_count; ++i)
+    {
+        if (memcmp(snapshots[i].rep.msg, trace[result->decoded].rep.msg, UART_TELEMETRY_REP_SIZE) != 0)
+        {
+            ++result->mismatches;
+        }
+        ++result->decoded;
+    }
+}
+
+static int bench_load (const char* path)
+{
+    FILE* file = fopen(path, "r");
+    char line[256];
+    uint32_t capacity = 0;
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        long tick, time, steer, throttle, brake_current, brake_next, distance, rx_queue, tx_queue;
+        long steer_target = 0, steer_rate = 0, steer_moving = 0, expired = 0;
+        uart_rep* snapshot;
+
+        if (sscanf(line, "%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld", &tick, &time, &steer, &throttle,
+                &brake_current, &brake_next, &distance, &rx_queue, &tx_queue, &steer_target, &steer_rate,
+                &steer_moving, &expired) < 9)
+        {
+            continue;     //başlık veya boş satır
+        }
+        if (trace_count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            trace = realloc(trace, capacity * sizeof(uart_rep));
+        }
+        snapshot = &trace[trace_count++];
+        memset(snapshot, 0, sizeof(*snapshot));
+        uart_set_TELEMETRY_REP_tick(snapshot, tick);
+        uart_set_TELEMETRY_REP_time(snapshot, time);
+        uart_set_TELEMETRY_REP_steer(snapshot, (uint16_t) steer);
+        uart_set_TELEMETRY_REP_throttle(snapshot, throttle);
+        uart_set_TELEMETRY_REP_brake_current(snapshot, brake_current);
+        uart_set_TELEMETRY_REP_brake_next(snapshot, brake_next);
+        uart_set_TELEMETRY_REP_distance(snapshot, distance);
+        uart_set_TELEMETRY_REP_rx_queue(snapshot, rx_queue);
+        uart_set_TELEMETRY_REP_tx_queue(snapshot, tx_queue);
+        uart_set_TELEMETRY_REP_steer_target(snapshot, (uint16_t) steer_target);
+        uart_set_TELEMETRY_REP_steer_rate(snapshot, (uint16_t) steer_rate);
+        uart_set_TELEMETRY_REP_steer_moving(snapshot, steer_moving);
+        uart_set_TELEMETRY_REP_expired(snapshot, expired);
+    }
+    fclose(file);
+    return (trace_count == 0) ? -1 : 0;
+}
+
+/**
+ * Planner 50 Hz te slalom için direksiyon hedefi gönderir, steer_target adım adım değişir. Motor hedefi
+ * STEERING_ACCELERATION ve STEERING_MAX_RATE ile izler, steer ve steer_rate her örnekte değişir.
+ * Gaz birkaç saniyede bir hız kademesi değiştirir, sonda fren kilitlenir. Ultrasonik sensör ~16 Hz te
+ * ölçer. time, transmit threadinin uyanmasındaki birkaç us lik sapmayı ve ara sıra daha öncelikli bir threadin
+ * gecikmesini içerir. Ara sıra bir snapshot atlanır.
+ * */
+static void bench_synthesize (uint16_t rate)
+{
+    static const uint16_t speeds[] = { SPEED_0, SPEED_5, SPEED_10, SPEED_15, SPEED_20, SPEED_15, SPEED_10 };
+    uint32_t period = 1000 / rate;
+    uint32_t tick = 1000;
+    uint32_t time = tick * 1000;
+    uint16_t distance = 300;
+    int16_t target = 0;
+    double steer = 0;
+    double steer_rate = 0;
+
+    trace_count = BENCH_SYNTHETIC_SECONDS * rate;
+    trace = calloc(trace_count, sizeof(uart_rep));
+    for (uint32_t i = 0; i < trace_count; ++i)
+    {
+        uart_rep* snapshot = &trace[i];
+        double seconds = (tick - 1000) / 1000.0;
+        uint32_t speed = (uint32_t) (seconds / 4) % (sizeof(speeds) / sizeof(speeds[0]));
+        uint8_t stopping = i >= trace_count - 2 * rate;
+
+        tick += (bench_random(0, 199) == 0) ? 2 * period : period;
+        time = tick * 1000 + bench_random(-3, 3) + ((bench_random(0, 19) == 0) ? 40 : 0);
+        if (tick % 20 < period)
+        {
+            target = (int16_t) (1200 * sin(2 * M_PI * seconds / 4));
+        }
+        bench_follow(target, period / 1000.0, &steer, &steer_rate);
+        if (tick % 60 < period)
+        {
+            distance = (uint16_t) (250 + 120 * sin(2 * M_PI * seconds / 9) + bench_random(-2, 2));
+        }
+        uart_set_TELEMETRY_REP_tick(snapshot, tick);
+        uart_set_TELEMETRY_REP_time(snapshot, time);
+        uart_set_TELEMETRY_REP_steer(snapshot, (uint16_t) (int16_t) lround(steer));
+        uart_set_TELEMETRY_REP_steer_target(snapshot, (uint16_t) target);
+        uart_set_TELEMETRY_REP_steer_rate(snapshot, (uint16_t) (int16_t) lround(steer_rate));
+        uart_set_TELEMETRY_REP_steer_moving(snapshot, steer_rate != 0);
+        uart_set_TELEMETRY_REP_throttle(snapshot, stopping ? SPEED_0 : speeds[speed]);
+        uart_set_TELEMETRY_REP_brake_current(snapshot, stopping ? BRAKE_LOCK : BRAKE_RELEASE);
+        uart_set_TELEMETRY_REP_brake_next(snapshot, stopping ? BRAKE_LOCK : BRAKE_RELEASE);
+        uart_set_TELEMETRY_REP_distance(snapshot, distance);
+        uart_set_TELEMETRY_REP_rx_queue(snapshot, bench_random(0, 19) == 0);
+        uart_set_TELEMETRY_REP_tx_queue(snapshot, bench_random(0, 9) == 0);
+    }
+}
+
+/**
+ * Direksiyon motorunu seconds kadar ilerletir. Hız, hedefte durabilecek en yüksek hıza ivme sınırıyla yaklaşır.
+ * */
+static void bench_follow (int16_t target, double seconds, double* position, double* rate)
+{
+    double remaining = target - *position;
+    double wanted = sqrt(2.0 * STEERING_ACCELERATION * fabs(remaining));
+    double change = STEERING_ACCELERATION * seconds;
+
+    wanted = (wanted > STEERING_MAX_RATE) ? STEERING_MAX_RATE : wanted;
+    wanted = (remaining < 0) ? -wanted : wanted;
+    *rate = (wanted > *rate + change) ? *rate + change : (wanted < *rate - change) ? *rate - change : wanted;
+    *position += *rate * seconds;
+    if ((remaining > 0 && *position >= target) || (remaining < 0 && *position <= target) || remaining == 0)
+    {
+        *position = target;
+        *rate = 0;
+    }
+}
+
+/**
+ * Her çalıştırmada aynı kaydı üretmek için sabit tohumlu LCG.
+ * */
+static int32_t bench_random (int32_t min, int32_t max)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return min + (int32_t) ((random_state >> 16) % (uint32_t) (max - min + 1));
+}
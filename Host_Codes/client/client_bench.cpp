@@ -0,0 +1,167 @@
+/**
+ * \file        client_bench.cpp
+ * \brief       VehicleClient ile CONTROL_REQ akışı gönderir ve gecikme yüzdeliklerini yazar.
+ *              loopback modunda firmware deki haberleşme katmanı, MainController ve controllerlar aynı
+ *              process te Host_Codes/shim/posix üzerinde bir pty ye bağlı çalışır, donanım gerekmez.
+ *              Diğer durumda verilen seri porttaki araçla konuşulur.
+ *              window 1 verilirse stop-and-wait ile pipeline karşılaştırılabilir.
+ *              Akıştan önce saat senkronize edilir ve komutların MCU da işlenmesine kadar geçen tek yön
+ *              gecikme de yazılır. loopback modunda iki saat aynı olduğu için drift ~0 çıkmalıdır.
+ *
+ *              Kullanım:
+ *                  ./client_bench loopback [count] [window]
+ *                  ./client_bench /dev/ttyACM0 [count] [window] [baudrate]
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  INC="-IHost_Codes/shim/posix -IHost_Codes/shim/hal -IHost_Codes/transport -I$FW/Inc -I$FW/Src \
+ *                      -I$FW/Src/Controllers -I$FW/Src/Communications -IHost_Codes/client"
+ *                  gcc -O2 -std=gnu11 -DUART_FRAME_SOFTWARE_CRC=1 $INC -c Host_Codes/shim/posix/posix_rtos.c \
+ *                      Host_Codes/shim/hal/hal.c Host_Codes/transport/pty_transport.c \
+ *                      $FW/Src/Communications/Communication_Mechanism.c $FW/Src/Communications/UART_Frame.c \
+ *                      $FW/Src/Communications/UART_Message.c $FW/Src/Communications/Flight_Recorder.c \
+ *                      $FW/Src/Communications/Telemetry_Codec.c $FW/Src/Controllers/MainController.c \
+ *                      $FW/Src/Controllers/BrakeController.c $FW/Src/Controllers/ThrottleController.c \
+ *                      $FW/Src/Controllers/SteerController.c $FW/Src/Controllers/HeartbeatSupervisor.c \
+ *                      $FW/Src/helpers.c
+ *                  g++ -O2 -std=c++17 -pthread -DUART_FRAME_SOFTWARE_CRC=1 $INC Host_Codes/client/client_bench.cpp \
+ *                      Host_Codes/client/vehicle_client.cpp Host_Codes/client/latency_stats.cpp \
+ *                      Host_Codes/client/clock_sync.cpp *.o -o client_bench
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "vehicle_client.h"
+#include "main.h"
+#include "BrakeController.h"
+#include "ThrottleController.h"
+#include "SteerController.h"
+#include "MainController.h"
+#include "Communication_Mechanism.h"
+#include "Sensors/hcsr04.h"
+#include "pty_transport.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+/*------------------------------< Defines >-----------------------------------*/
+#define CLIENT_BENCH_DEFAULT_COUNT (20000)
+#define CLIENT_BENCH_MAX_QUEUED (64)     //planner ın önden kuyruğa koyduğu komut sayısı
+#define CLIENT_BENCH_IDLE_TIMEOUT (5000)     //ms
+#define CLIENT_BENCH_SYNC_COUNT (16)     //akıştan önceki SYNC_REQ sayısı
+/*------------------------------< Prototypes >--------------------------------*/
+static std::string client_bench_start_loopback ( );
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    using vehicle::CommandResult;
+    using vehicle::CommandStatus;
+
+    uint32_t count = (argc >= 3) ? strtoul(argv[2], NULL, 0) : CLIENT_BENCH_DEFAULT_COUNT;
+    uint8_t window = (argc >= 4) ? (uint8_t) strtoul(argv[3], NULL, 0) : UART_ACK_WINDOW;
+    uint32_t baudrate = (argc >= 5) ? strtoul(argv[4], NULL, 0) : 115200;
+    uint32_t status_count[5] = { };
+    std::string path;
+    struct timespec start;
+    struct timespec end;
+    int fd;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s loopback [count] [window]\n       %s <tty> [count] [window] [baudrate]\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    path = (strcmp(argv[1], "loopback") == 0) ? client_bench_start_loopback() : argv[1];
+    if ((fd = vehicle::VehicleClient::open_serial(path, baudrate)) < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    vehicle::VehicleClient client(fd);
+    CommandStatus start_status = CommandStatus::Timeout;
+
+    client.start([&start_status] (const CommandResult& result) { start_status = result.status; });
+    if (!client.run_until_idle(CLIENT_BENCH_IDLE_TIMEOUT) || start_status != CommandStatus::Ok)
+    {
+        fprintf(stderr, "START was not accepted\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < CLIENT_BENCH_SYNC_COUNT; ++i)
+    {
+        client.sync();
+        client.run_until_idle(CLIENT_BENCH_IDLE_TIMEOUT);
+    }
+    client.latency().clear();
+    client.set_window(window);
+
+    vehicle::LatencyStats uplink;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        while (client.queued() >= CLIENT_BENCH_MAX_QUEUED)
+        {
+            client.poll(-1);
+        }
+        client.control(0, (i % 2) ? 100 : 0, CONTROL_THROTTLE_KEEP, CONTROL_BRAKE_KEEP,
+                [&status_count, &uplink] (const CommandResult& result)
+                {
+                    ++status_count[(int) result.status];
+                    if (result.processed_ns > result.sent_ns)
+                    {
+                        uplink.add(result.processed_ns - result.sent_ns);
+                    }
+                });
+    }
+    client.run_until_idle(CLIENT_BENCH_IDLE_TIMEOUT);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    vehicle::LatencyStats& latency = client.latency(CONTROL_REQ);
+    vehicle::ClockSync& clock = client.clock();
+
+    printf("link              : %s, window %u\n", path.c_str(), window);
+    printf("commands          : %u sent, %zu acked, %llu timed out\n", count, latency.count(),
+            (unsigned long long) client.timeout_count());
+    printf("results           : ok %u error %u unknown %u superseded %u\n", status_count[(int) CommandStatus::Ok],
+            status_count[(int) CommandStatus::Error], status_count[(int) CommandStatus::Unknown],
+            status_count[(int) CommandStatus::Superseded]);
+    printf("throughput        : %.0f cmd/s\n", count / elapsed);
+    printf("latency           : mean %.1f us, p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+            latency.mean() / 1e3, latency.percentile(50) / 1e3, latency.percentile(90) / 1e3,
+            latency.percentile(99) / 1e3, latency.percentile(99.9) / 1e3, latency.max() / 1e3);
+    printf("clock sync        : %zu samples, offset %.1f us, drift %.2f ppm, min rtt %.1f us\n", clock.count(),
+            clock.offset_us(), clock.drift_ppm(), clock.rtt_min_ns() / 1e3);
+    printf("uplink            : %zu samples, p50 %.1f us, p99 %.1f us, max %.1f us\n", uplink.count(),
+            uplink.percentile(50) / 1e3, uplink.percentile(99) / 1e3, uplink.max() / 1e3);
+    return client.timeout_count() != 0;
+}
+
+/*
+ * Sensör yerine geçen fonksiyon.
+ */
+
+extern "C" uint16_t hcsr04_get_distance ( )
+{
+    return 0;
+}
+
+/**
+ * main.c deki sırayla firmware i pty üzerinde başlatır ve slave in yolunu döner.
+ * */
+static std::string client_bench_start_loopback ( )
+{
+    EMERGENCY_STOP_GPIO_Port->IDR |= EMERGENCY_STOP_Pin;     //acil stop butonu basılı değil
+    brake_init();
+    throttle_set_value(SPEED_0);
+    throttle_set_lock(THROTTLE_LOCK);
+    steer_init();
+    communication_init(&pty_transport);
+    main_controller_init();
+    return pty_transport_get_slave_name();
+}
@@ -0,0 +1,171 @@
+/**
+ * \file        clock_sync.cpp
+ * \brief       MCU saatini host saatine çevirir. Her SYNC_REQ/SYNC_REP alışverişi dört zaman verir:
+ *              t1 host gönderme, t2 MCU alma (IDLE kesmesindeki DWT), t3 MCU gönderme, t4 host alma.
+ *              NTP deki gibi offset = ((t2 - t1) + (t3 - t4)) / 2, gecikme = (t4 - t1) - (t3 - t2) dir.
+ *              Hat simetrik değilse veya çerçeve bir kuyrukta beklediyse offset hatası gecikmenin yarısına
+ *              kadar çıkabilir. Bu yüzden penceredeki en kısa gecikmeli örneklere yakın olanlar seçilir ve
+ *              offset bunlara host zamanına göre en küçük kareler ile doğru uydurularak bulunur.
+ *              Doğrunun eğimi iki kristalin frekans farkıdır (drift). Kısa süreli ölçümlerde eğim güvenilir
+ *              olmadığı için pencere CLOCK_SYNC_MIN_DRIFT_SPAN ten kısaysa drift 0 kabul edilir.
+ *              MCU zamanı 32 bit µs tir ve ~71 dakikada taşar. Son örneğe en yakın değere açılarak
+ *              kullanılır, bu yüzden çevrilecek zamanın son senkronizasyondan ±35 dakika içinde olması gerekir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "clock_sync.h"
+#include <algorithm>
+#include <cmath>
+/*------------------------------< Defines >-----------------------------------*/
+#define CLOCK_SYNC_DELAY_SLACK (50.0)     //µs, en kısa gecikmeden bu kadar uzun örnekler de kullanılır
+#define CLOCK_SYNC_MIN_DRIFT_SPAN (1e6)     //µs, drift hesabı için gereken en kısa pencere süresi
+/*------------------------------< Functions >---------------------------------*/
+namespace vehicle
+{
+
+ClockSync::ClockSync (size_t window) :
+        window_(std::max<size_t>(window, 1))
+{
+}
+
+/**
+ * Host zamanları CLOCK_MONOTONIC ns, MCU zamanları SYNC_REP teki µs değerleridir.
+ * */
+void ClockSync::add_sample (uint64_t host_tx_ns, uint32_t mcu_rx_us, uint32_t mcu_tx_us, uint64_t host_rx_ns)
+{
+    double t1 = host_tx_ns / 1e3;
+    double t4 = host_rx_ns / 1e3;
+    int64_t t2 = samples_.empty() ? (int64_t) mcu_rx_us : unwrap(mcu_rx_us);
+    int64_t t3 = t2 + (int32_t) (mcu_tx_us - mcu_rx_us);
+    Sample sample;
+
+    if (t4 < t1 || t3 < t2)
+    {
+        return;
+    }
+    mcu_reference_us_ = t3;
+    sample.host_us = (t1 + t4) / 2;
+    sample.offset_us = ((t2 - t1) + (t3 - t4)) / 2;
+    sample.rtt_us = std::max((t4 - t1) - (double) (t3 - t2), 0.0);
+    samples_.push_back(sample);
+    if (samples_.size() > window_)
+    {
+        samples_.pop_front();
+    }
+    estimate();
+}
+
+void ClockSync::clear ( )
+{
+    samples_.clear();
+    mcu_reference_us_ = 0;
+    base_host_us_ = 0;
+    base_offset_us_ = 0;
+    drift_ = 0;
+}
+
+bool ClockSync::synced ( ) const
+{
+    return !samples_.empty();
+}
+
+size_t ClockSync::count ( ) const
+{
+    return samples_.size();
+}
+
+double ClockSync::offset_us ( ) const
+{
+    return base_offset_us_;
+}
+
+double ClockSync::drift_ppm ( ) const
+{
+    return drift_ * 1e6;
+}
+
+uint64_t ClockSync::rtt_min_ns ( ) const
+{
+    double rtt = INFINITY;
+
+    for (const Sample& sample : samples_)
+    {
+        rtt = std::min(rtt, sample.rtt_us);
+    }
+    return samples_.empty() ? 0 : (uint64_t) (rtt * 1e3);
+}
+
+/**
+ * mcu = host + offset + drift * (host - base_host) denkleminden host çözülür. Senkronizasyon yoksa 0 döner.
+ * */
+uint64_t ClockSync::to_host_ns (uint32_t mcu_us) const
+{
+    if (samples_.empty())
+    {
+        return 0;
+    }
+    double mcu = (double) unwrap(mcu_us);
+    double host = (mcu - base_offset_us_ + drift_ * base_host_us_) / (1 + drift_);
+    return (host <= 0) ? 0 : (uint64_t) (host * 1e3);
+}
+
+int64_t ClockSync::unwrap (uint32_t mcu_us) const
+{
+    return mcu_reference_us_ + (int32_t) (mcu_us - (uint32_t) mcu_reference_us_);
+}
+
+/**
+ * En kısa gecikmeye CLOCK_SYNC_DELAY_SLACK kadar yakın örneklerle offset = a + drift * (host - ortalama)
+ * uydurulur. Sonuç son örneğin anına taşınır, to_host_ns bu noktadan itibaren doğruyu uzatır.
+ * */
+void ClockSync::estimate ( )
+{
+    double rtt_min = INFINITY;
+    double sum_host = 0;
+    double sum_offset = 0;
+    double host_min = INFINITY;
+    double host_max = -INFINITY;
+    size_t n = 0;
+
+    for (const Sample& sample : samples_)
+    {
+        rtt_min = std::min(rtt_min, sample.rtt_us);
+    }
+    for (const Sample& sample : samples_)
+    {
+        if (sample.rtt_us <= rtt_min + CLOCK_SYNC_DELAY_SLACK)
+        {
+            sum_host += sample.host_us;
+            sum_offset += sample.offset_us;
+            host_min = std::min(host_min, sample.host_us);
+            host_max = std::max(host_max, sample.host_us);
+            ++n;
+        }
+    }
+
+    double mean_host = sum_host / n;
+    double mean_offset = sum_offset / n;
+    double sxx = 0;
+    double sxy = 0;
+
+    drift_ = 0;
+    if (host_max - host_min >= CLOCK_SYNC_MIN_DRIFT_SPAN)
+    {
+        for (const Sample& sample : samples_)
+        {
+            if (sample.rtt_us <= rtt_min + CLOCK_SYNC_DELAY_SLACK)
+            {
+                sxx += (sample.host_us - mean_host) * (sample.host_us - mean_host);
+                sxy += (sample.host_us - mean_host) * (sample.offset_us - mean_offset);
+            }
+        }
+        drift_ = sxy / sxx;
+    }
+    base_host_us_ = samples_.back().host_us;
+    base_offset_us_ = mean_offset + drift_ * (base_host_us_ - mean_host);
+}
+
+}     // namespace vehicle
@@ -0,0 +1,59 @@
+/**
+ * \file        clock_sync.h
+ * \brief       SYNC_REQ/SYNC_REP ölçümlerinden MCU saati ile host saati arasındaki offset ve drift i tahmin eder.
+ *              Detaylı bilgiyi clock_sync.cpp de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_CLIENT_CLOCK_SYNC_H_
+#define HOST_CLIENT_CLOCK_SYNC_H_
+
+/*------------------------------< Includes >----------------------------------*/
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+namespace vehicle
+{
+
+class ClockSync
+{
+public:
+    explicit ClockSync (size_t window = 64);
+
+    void add_sample (uint64_t host_tx_ns, uint32_t mcu_rx_us, uint32_t mcu_tx_us, uint64_t host_rx_ns);
+    void clear ( );
+    bool synced ( ) const;
+    size_t count ( ) const;
+
+    double offset_us ( ) const;     //MCU - host, son örneğin anında
+    double drift_ppm ( ) const;     //MCU saatinin host saatine göre hızı, pozitifse MCU ileri kayar
+    uint64_t rtt_min_ns ( ) const;     //penceredeki en kısa gidiş-dönüş, MCU daki bekleme hariç
+    uint64_t to_host_ns (uint32_t mcu_us) const;     //MCU zamanını host CLOCK_MONOTONIC ns ye çevirir
+
+private:
+    struct Sample
+    {
+        double host_us;     //t1 ile t4 ün ortası
+        double offset_us;
+        double rtt_us;
+    };
+
+    int64_t unwrap (uint32_t mcu_us) const;
+    void estimate ( );
+
+    size_t window_;
+    std::deque<Sample> samples_;
+    int64_t mcu_reference_us_ = 0;     //32 bit MCU zamanları buna en yakın değere açılır
+    double base_host_us_ = 0;
+    double base_offset_us_ = 0;
+    double drift_ = 0;
+};
+
+}     // namespace vehicle
+
+#endif /* HOST_CLIENT_CLOCK_SYNC_H_ */
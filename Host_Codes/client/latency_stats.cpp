@@ -0,0 +1,68 @@
+/**
+ * \file        latency_stats.cpp
+ * \brief       Detaylı bilgiyi latency_stats.h de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "latency_stats.h"
+#include <algorithm>
+/*------------------------------< Functions >---------------------------------*/
+namespace vehicle
+{
+
+void LatencyStats::add (uint64_t ns)
+{
+    samples_.push_back(ns);
+    sum_ += ns;
+    max_ = std::max(max_, ns);
+    sorted_ = false;
+}
+
+void LatencyStats::clear ( )
+{
+    samples_.clear();
+    sum_ = 0;
+    max_ = 0;
+    sorted_ = true;
+}
+
+size_t LatencyStats::count ( ) const
+{
+    return samples_.size();
+}
+
+double LatencyStats::mean ( ) const
+{
+    return samples_.empty() ? 0.0 : (double) sum_ / samples_.size();
+}
+
+uint64_t LatencyStats::max ( ) const
+{
+    return max_;
+}
+
+/**
+ * Nearest-rank yöntemi, p=50 medyan, p=100 en büyük örnek.
+ * */
+uint64_t LatencyStats::percentile (double p)
+{
+    size_t rank;
+
+    if (samples_.empty())
+    {
+        return 0;
+    }
+    if (!sorted_)
+    {
+        std::sort(samples_.begin(), samples_.end());
+        sorted_ = true;
+    }
+    rank = (size_t) (p / 100.0 * samples_.size() + 0.5);
+    rank = std::min(std::max(rank, (size_t) 1), samples_.size());
+    return samples_[rank - 1];
+}
+
+}     // namespace vehicle
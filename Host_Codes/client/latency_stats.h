@@ -0,0 +1,42 @@
+/**
+ * \file        latency_stats.h
+ * \brief       Komut gecikmelerini (ns) biriktirir ve yüzdelik değerlerini hesaplar.
+ *              Örnekler tutulur, yüzdelik istendiğinde bir kez sıralanır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_CLIENT_LATENCY_STATS_H_
+#define HOST_CLIENT_LATENCY_STATS_H_
+
+/*------------------------------< Includes >----------------------------------*/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+namespace vehicle
+{
+
+class LatencyStats
+{
+public:
+    void add (uint64_t ns);
+    void clear ( );
+    size_t count ( ) const;
+    double mean ( ) const;
+    uint64_t max ( ) const;
+    uint64_t percentile (double p);     //p 0..100, örnek yoksa 0
+
+private:
+    std::vector<uint64_t> samples_;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+    bool sorted_ = true;
+};
+
+}     // namespace vehicle
+
+#endif /* HOST_CLIENT_LATENCY_STATS_H_ */
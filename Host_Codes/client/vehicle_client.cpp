@@ -0,0 +1,585 @@
+/**
+ * \file        vehicle_client.cpp
+ * \brief       Çerçeveli protokol için asenkron, pipeline lı host istemcisi.
+ *              Komutlar send() ile kuyruğa konulur ve hemen döner. Sonuç, komutu kapsayan ilk ACK_REP
+ *              okunduğunda callback ile bildirilir. Bu sırada başka komutlar da hatta olabilir, istemci
+ *              her komutu bir önceki ACK ı beklemeden gönderir.
+ *              ACK_REP sadece son UART_ACK_WINDOW sıra numarasını kapsar. Bu yüzden bir komut, kendisinden
+ *              window sıra numarası önceki komut cevaplanmadan gönderilmez. Fazlası kuyrukta bekler.
+ *              Sayı yerine sıra numarası aralığı sınırlanır: controllerda işlenen bir komut cevaplanmadan
+ *              sonraki setpointler mailbox ta üzerine yazılıp cevaplanabilir.
+ *              Hat non-blocking açılır ve epoll ile beklenir. Yazma buffer ı dolarsa EPOLLOUT beklenir.
+ *              Sınıf thread-safe değildir, send() ve poll() aynı threadden çağrılmalıdır.
+ *              sync() ile gönderilen SYNC_REQ lerin cevapları clock() taki ClockSync a verilir. Saat senkronize
+ *              olduktan sonra ACK_REP ve TELEMETRY_REP teki MCU zamanları host zamanına çevrilebilir.
+ *              TELEMETRY_REP ve TELEMETRY_DELTA_REP ler Telemetry_Codec ile açılır ve on_telemetry callback ine
+ *              snapshot başına verilir. Bir delta çerçevesi kaybolursa sıradaki keyframe e kadar snapshot gelmez.
+ *              set_flow_control(true) ile pencereye ek olarak ACK_REP teki credit sınırı da uygulanır.
+ *              MCU nun queue suna sığmayacak komut gönderilmez, komutlar dolu queue yüzünden reddedilmez.
+ *              Sadece çerçeveli protokol (UART_FRAMED_PROTOCOL 1) desteklenir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "vehicle_client.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define VEHICLE_CLIENT_READ_CHUNK (256)
+/*------------------------------< Functions >---------------------------------*/
+namespace vehicle
+{
+
+/**
+ * fd nin sahipliği alınmaz, fd non-blocking yapılır.
+ * */
+VehicleClient::VehicleClient (int fd) :
+        fd_(fd), epoll_fd_(epoll_create1(EPOLL_CLOEXEC))
+{
+    struct epoll_event event = { };
+
+    if (epoll_fd_ < 0)
+    {
+        throw std::runtime_error(std::string("epoll_create1: ") + strerror(errno));
+    }
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+    event.events = EPOLLIN;
+    event.data.fd = fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &event) != 0)
+    {
+        close(epoll_fd_);
+        throw std::runtime_error(std::string("epoll_ctl: ") + strerror(errno));
+    }
+    uart_frame_parser_init(&parser_);
+    telemetry_decoder_init(&telemetry_decoder_);
+}
+
+VehicleClient::~VehicleClient ( )
+{
+    close(epoll_fd_);
+}
+
+/**
+ * Seri portu raw modda açar. Hata olursa veya termios bu hızı bilmiyorsa -1 döner.
+ * pty lerde baud rate yok sayılır.
+ * */
+int VehicleClient::open_serial (const std::string& path, uint32_t baudrate)
+{
+    static const struct
+    {
+        uint32_t baudrate;
+        speed_t speed;
+    } speeds[] = { { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+            { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 }, { 921600, B921600 },
+            { 1000000, B1000000 }, { 2000000, B2000000 } };
+    struct termios tio;
+    int fd;
+
+    auto it = std::find_if(std::begin(speeds), std::end(speeds),
+            [baudrate] (const auto& entry) { return entry.baudrate == baudrate; });
+    if (it == std::end(speeds) || (fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0)
+    {
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, it->speed);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/**
+ * Komutu kuyruğa koyar ve pencere izin veriyorsa hemen gönderir. validity_ms 0 değilse
+ * çerçeveye geçerlilik süresi olarak eklenir. Dönen numara callback teki CommandResult::id dir.
+ * */
+uint64_t VehicleClient::send (const uart_req& req, CommandCallback callback, uint8_t validity_ms)
+{
+    Command command;
+    uint64_t id = next_id_++;
+
+    command.id = id;
+    command.len = get_req_msg_size(&req);
+    memcpy(command.payload, req.req.msg, command.len);
+    if (validity_ms != 0)
+    {
+        command.payload[command.len++] = validity_ms;
+    }
+    command.callback = std::move(callback);
+    queue_.push_back(std::move(command));
+    transmit_queued();
+    return id;
+}
+
+uint64_t VehicleClient::start (CommandCallback callback)
+{
+    uart_req req = { };
+
+    uart_set_START_STOP_REQ_val(&req, 1);
+    return send(req, std::move(callback));
+}
+
+uint64_t VehicleClient::stop (CommandCallback callback)
+{
+    uart_req req = { };
+
+    uart_set_START_STOP_REQ_val(&req, 0);
+    return send(req, std::move(callback));
+}
+
+uint64_t VehicleClient::control (uint8_t steer_dir, uint16_t steer_val, uint8_t throttle, uint8_t brake,
+        CommandCallback callback, uint8_t validity_ms)
+{
+    uart_req req = { };
+
+    uart_set_CONTROL_REQ_steer_dir(&req, steer_dir);
+    uart_set_CONTROL_REQ_steer_val(&req, steer_val);
+    uart_set_CONTROL_REQ_throttle(&req, throttle);
+    uart_set_CONTROL_REQ_brake(&req, brake);
+    return send(req, std::move(callback), validity_ms);
+}
+
+/**
+ * SYNC_REQ in host_time alanı çerçeve yazılırken doldurulur, böylece pencerede bekleme süresi offset e girmez.
+ * Daha doğru bir tahmin için birkaç kez çağrılmalıdır. Cevap ayrıca SYNC_REP callback ine de verilir.
+ * */
+uint64_t VehicleClient::sync (CommandCallback callback)
+{
+    uart_req req = { };
+
+    req.req_packed.header = SYNC_REQ;
+    return send(req, std::move(callback));
+}
+
+/**
+ * ACK_REP dışındaki cevaplar (STATE_REP, CONTROL_REP, TELEMETRY_REP, ...) header a göre bu callbacklere verilir.
+ * */
+void VehicleClient::on_reply (uint8_t header, ReplyCallback callback)
+{
+    if (header < UART_HEADER_COUNT)
+    {
+        reply_callbacks_[header] = std::move(callback);
+    }
+}
+
+/**
+ * Telemetri sıkıştırılmış olsun veya olmasın callback snapshot başına çağrılır.
+ * */
+void VehicleClient::on_telemetry (TelemetryCallback callback)
+{
+    telemetry_callback_ = std::move(callback);
+}
+
+/**
+ * Event loop un bir adımı. En fazla timeout_ms bekler (-1 sonsuz), en yakın komut timeout u daha
+ * erkense o kadar bekler. İşlenen event sayısını döner.
+ * */
+int VehicleClient::poll (int timeout_ms)
+{
+    struct epoll_event events[1];
+    int count = epoll_wait(epoll_fd_, events, 1, next_timeout_ms(timeout_ms));
+
+    if (count > 0)
+    {
+        if (events[0].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+        {
+            handle_input();
+        }
+        if (events[0].events & EPOLLOUT)
+        {
+            flush_tx();
+        }
+    }
+    expire(now_ns());
+    transmit_queued();
+    return std::max(count, 0);
+}
+
+/**
+ * Kuyruk ve hattaki komutlar bitene kadar poll eder. timeout_ms içinde bitmezse false döner.
+ * */
+bool VehicleClient::run_until_idle (int timeout_ms)
+{
+    uint64_t deadline = now_ns() + (uint64_t) timeout_ms * 1000000ULL;
+
+    while (in_flight_ != 0 || !queue_.empty() || tx_offset_ < tx_buffer_.size())
+    {
+        uint64_t now = now_ns();
+        if (now >= deadline)
+        {
+            return false;
+        }
+        poll((int) ((deadline - now) / 1000000ULL) + 1);
+    }
+    return true;
+}
+
+/**
+ * 1 stop-and-wait davranışını verir, en fazla UART_ACK_WINDOW.
+ * */
+void VehicleClient::set_window (uint8_t window)
+{
+    window_ = std::min<uint8_t>(std::max<uint8_t>(window, 1), UART_ACK_WINDOW);
+}
+
+void VehicleClient::set_timeout (std::chrono::milliseconds timeout)
+{
+    timeout_ns_ = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+}
+
+/**
+ * Credit modunda komutlar, son ACK_REP in bildirdiği rx_seq + credits sıra numarasına kadar gönderilir.
+ * Hatta komut yokken credit olmasa da bir komut gönderilir, ilk ve kaybolan ACK_REP ler için sınır böyle
+ * tazelenir.
+ * */
+void VehicleClient::set_flow_control (bool enabled)
+{
+    flow_control_ = enabled;
+}
+
+size_t VehicleClient::in_flight ( ) const
+{
+    return in_flight_;
+}
+
+size_t VehicleClient::queued ( ) const
+{
+    return queue_.size();
+}
+
+uint64_t VehicleClient::timeout_count ( ) const
+{
+    return timeout_count_;
+}
+
+/**
+ * Son ACK_REP gönderilirken controllerın işlemeyi beklediği request sayısı.
+ * */
+uint8_t VehicleClient::mcu_queue ( ) const
+{
+    return mcu_queue_;
+}
+
+/**
+ * Credit sınırına göre şu an gönderilebilecek komut sayısı.
+ * */
+uint8_t VehicleClient::credits ( ) const
+{
+    int8_t credits = (int8_t) (credit_limit_ - tx_seq_) + 1;
+
+    return (credits > 0) ? credits : 0;
+}
+
+/**
+ * Keyframe beklenirken atlanan delta çerçeveleri de sayılır.
+ * */
+uint16_t VehicleClient::telemetry_lost_frames ( ) const
+{
+    return telemetry_decoder_.lost_frames;
+}
+
+LatencyStats& VehicleClient::latency ( )
+{
+    return latency_;
+}
+
+LatencyStats& VehicleClient::latency (uint8_t header)
+{
+    return header_latency_.at(header);
+}
+
+ClockSync& VehicleClient::clock ( )
+{
+    return clock_;
+}
+
+/**
+ * Pencere izin verdiği sürece kuyruktaki komutlara sıra numarası verir ve çerçeveleri yazar.
+ * Gönderilecek sıra numarasından window kadar önceki komut hala bekliyorsa durulur.
+ * Credit bittiyse kuyrukta credit beklemeyen bir STOP aranır ve bekleyen setpointlerin önünde gönderilir.
+ * */
+void VehicleClient::transmit_queued ( )
+{
+    uint8_t frame[UART_FRAME_MAX_SIZE];
+    bool wrote = false;
+
+    while (!queue_.empty() && !pending_[(uint8_t) (tx_seq_ - window_)].waiting)
+    {
+        auto next = std::find_if(queue_.begin(), queue_.end(),
+                [this](const Command& command) { return has_credit(command); });
+        if (next == queue_.end())
+        {
+            break;
+        }
+        Command& command = *next;
+        Pending& pending = pending_[tx_seq_];
+
+        pending.waiting = true;
+        pending.id = command.id;
+        pending.header = command.payload[0];
+        pending.sent_ns = now_ns();
+        pending.callback = std::move(command.callback);
+        ++in_flight_;
+        if (pending.header == SYNC_REQ && command.len >= UART_SYNC_REQ_SIZE)
+        {
+            uart_req req;
+
+            memcpy(req.req.msg, command.payload, UART_SYNC_REQ_SIZE);
+            uart_set_SYNC_REQ_host_time(&req, (uint32_t) (pending.sent_ns / 1000));
+            memcpy(command.payload, req.req.msg, UART_SYNC_REQ_SIZE);
+        }
+        uint8_t len = uart_frame_encode(command.payload, command.len, tx_seq_++, frame);
+        tx_buffer_.insert(tx_buffer_.end(), frame, frame + len);
+        queue_.erase(next);
+        wrote = true;
+    }
+    if (wrote)
+    {
+        flush_tx();
+    }
+}
+
+/**
+ * STOP credit beklemez, MCU onu queue dan önce receive threadinde uygular.
+ * */
+bool VehicleClient::has_credit (const Command& command) const
+{
+    uart_req req = { };
+
+    if (!flow_control_ || in_flight_ == 0 || credits() > 0)
+    {
+        return true;
+    }
+    memcpy(req.req.msg, command.payload, std::min<size_t>(command.len, sizeof(req)));
+    return command.payload[0] == START_STOP_REQ && uart_get_START_STOP_REQ_val(&req) == 0;
+}
+
+void VehicleClient::flush_tx ( )
+{
+    while (tx_offset_ < tx_buffer_.size())
+    {
+        ssize_t written = write(fd_, tx_buffer_.data() + tx_offset_, tx_buffer_.size() - tx_offset_);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;     //EAGAIN, EPOLLOUT beklenir
+        }
+        tx_offset_ += written;
+    }
+    if (tx_offset_ == tx_buffer_.size())
+    {
+        tx_buffer_.clear();
+        tx_offset_ = 0;
+    }
+    update_events();
+}
+
+void VehicleClient::update_events ( )
+{
+    bool want_write = tx_offset_ < tx_buffer_.size();
+    struct epoll_event event = { };
+
+    if (want_write == want_write_)
+    {
+        return;
+    }
+    want_write_ = want_write;
+    event.events = EPOLLIN | (want_write ? (uint32_t) EPOLLOUT : 0U);
+    event.data.fd = fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd_, &event);
+}
+
+void VehicleClient::handle_input ( )
+{
+    uint8_t chunk[VEHICLE_CLIENT_READ_CHUNK];
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE];
+    uint8_t payload_len;
+    uint8_t seq;
+    ssize_t len;
+
+    while ((len = read(fd_, chunk, sizeof(chunk))) > 0)
+    {
+        uint64_t now = now_ns();
+
+        for (ssize_t i = 0; i < len; ++i)
+        {
+            //Bir byte birden fazla çerçeveyi tamamlayabilir, buffer da kalanlar bir sonraki byte beklenmeden alınır.
+            for (Return_Status status = uart_frame_parse_byte(&parser_, chunk[i], payload, &payload_len, &seq);
+                    status == OK; status = uart_frame_parse_next(&parser_, payload, &payload_len, &seq))
+            {
+                uart_rep rep = { };
+
+                memcpy(rep.rep.msg, payload, std::min<size_t>(payload_len, sizeof(rep)));
+                if (payload[0] == ACK_REP && payload_len == UART_ACK_REP_SIZE)
+                {
+                    handle_ack(rep);
+                    continue;
+                }
+                if (payload[0] == SYNC_REP && payload_len == UART_SYNC_REP_SIZE)
+                {
+                    handle_sync(rep, now);
+                }
+                if ((payload[0] == TELEMETRY_REP && payload_len == UART_TELEMETRY_REP_SIZE)
+                        || payload[0] == TELEMETRY_DELTA_REP)
+                {
+                    handle_telemetry(payload, payload_len, rep);
+                }
+                if (payload[0] < UART_HEADER_COUNT && reply_callbacks_[payload[0]])
+                {
+                    reply_callbacks_[payload[0]](rep, payload_len);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * ACK_REP in kapsadığı ve hala bekleyen her komut tamamlanır. Aynı komut sonraki ACK_REP lerde
+ * tekrar gelirse atlanır. ACK_REP teki MCU zamanı sadece en son sıra numarasına aittir.
+ * */
+void VehicleClient::handle_ack (const uart_rep& rep)
+{
+    uint64_t now = now_ns();
+    uint8_t seq = uart_get_ACK_REP_seq(&rep);
+    uint8_t received = uart_get_ACK_REP_received(&rep);
+    uint16_t results = uart_get_ACK_REP_results(&rep);
+    uint64_t processed_ns = clock_.to_host_ns(uart_get_ACK_REP_time(&rep));
+
+    mcu_queue_ = uart_get_ACK_REP_rx_queue(&rep);
+    credit_limit_ = uart_get_ACK_REP_rx_seq(&rep) + uart_get_ACK_REP_credits(&rep);
+
+    for (uint8_t i = 0; i < UART_ACK_WINDOW; ++i)
+    {
+        if (received & (1 << i))
+        {
+            complete((uint8_t) (seq - i), (CommandStatus) ((results >> (2 * i)) & 0x3), now,
+                    (i == 0) ? processed_ns : 0);
+        }
+    }
+}
+
+/**
+ * t1 host_time in 32 bitlik us değerinden, now a en yakın değere açılarak bulunur. now çerçevenin
+ * okunduğu andır, t4 olarak kullanılır.
+ * */
+void VehicleClient::handle_sync (const uart_rep& rep, uint64_t now)
+{
+    uint64_t now_us = now / 1000;
+    uint64_t sent_us = now_us - (uint32_t) ((uint32_t) now_us - uart_get_SYNC_REP_host_time(&rep));
+
+    clock_.add_sample(sent_us * 1000, uart_get_SYNC_REP_rx_time(&rep), uart_get_SYNC_REP_tx_time(&rep), now);
+}
+
+void VehicleClient::handle_telemetry (const uint8_t* payload, uint8_t len, const uart_rep& rep)
+{
+    uart_rep snapshots[TELEMETRY_CODEC_MAX_SAMPLES];
+    uint8_t count;
+
+    if (payload[0] == TELEMETRY_REP)
+    {
+        telemetry_decoder_keyframe(&telemetry_decoder_, &rep);
+        snapshots[0] = rep;
+        count = 1;
+    }
+    else
+    {
+        count = telemetry_decoder_decode(&telemetry_decoder_, payload, len, snapshots, TELEMETRY_CODEC_MAX_SAMPLES);
+    }
+    for (uint8_t i = 0; i < count && telemetry_callback_; ++i)
+    {
+        telemetry_callback_(snapshots[i]);
+    }
+}
+
+void VehicleClient::complete (uint8_t seq, CommandStatus status, uint64_t now, uint64_t processed_ns)
+{
+    Pending& pending = pending_[seq];
+    CommandResult result;
+
+    if (!pending.waiting)
+    {
+        return;
+    }
+    pending.waiting = false;
+    --in_flight_;
+    result.id = pending.id;
+    result.header = pending.header;
+    result.seq = seq;
+    result.status = status;
+    result.latency_ns = now - pending.sent_ns;
+    result.sent_ns = pending.sent_ns;
+    result.processed_ns = processed_ns;
+    if (status != CommandStatus::Timeout)
+    {
+        latency_.add(result.latency_ns);
+        if (pending.header < UART_HEADER_COUNT)
+        {
+            header_latency_[pending.header].add(result.latency_ns);
+        }
+    }
+    if (pending.callback)
+    {
+        CommandCallback callback = std::move(pending.callback);
+        pending.callback = nullptr;
+        callback(result);
+    }
+}
+
+void VehicleClient::expire (uint64_t now)
+{
+    if (in_flight_ == 0)
+    {
+        return;
+    }
+    for (size_t seq = 0; seq < pending_.size(); ++seq)
+    {
+        if (pending_[seq].waiting && now - pending_[seq].sent_ns >= timeout_ns_)
+        {
+            ++timeout_count_;
+            complete((uint8_t) seq, CommandStatus::Timeout, now);
+        }
+    }
+}
+
+int VehicleClient::next_timeout_ms (int timeout_ms) const
+{
+    uint64_t now = now_ns();
+    uint64_t earliest = UINT64_MAX;
+
+    for (const Pending& pending : pending_)
+    {
+        if (pending.waiting)
+        {
+            earliest = std::min(earliest, pending.sent_ns + timeout_ns_);
+        }
+    }
+    if (earliest == UINT64_MAX)
+    {
+        return timeout_ms;
+    }
+    int expire_ms = (earliest <= now) ? 0 : (int) ((earliest - now + 999999ULL) / 1000000ULL);
+    return (timeout_ms < 0) ? expire_ms : std::min(timeout_ms, expire_ms);
+}
+
+uint64_t VehicleClient::now_ns ( )
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+}     // namespace vehicle
@@ -0,0 +1,150 @@
+/**
+ * \file        vehicle_client.h
+ * \brief       Çerçeveli protokol için asenkron host istemcisi. Detaylı bilgiyi vehicle_client.cpp de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_CLIENT_VEHICLE_CLIENT_H_
+#define HOST_CLIENT_VEHICLE_CLIENT_H_
+
+/*------------------------------< Includes >----------------------------------*/
+#include "UART_Message.h"
+#include "UART_Frame.h"
+#include "Telemetry_Codec.h"
+#include "latency_stats.h"
+#include "clock_sync.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+namespace vehicle
+{
+
+enum class CommandStatus
+{
+    Error = ACK_ERROR,
+    Ok = ACK_OK,
+    Unknown = ACK_UNKNOWN,
+    Superseded = ACK_SUPERSEDED,
+    Timeout     //süresi içinde hiçbir ACK_REP bu komutu kapsamadı
+};
+
+struct CommandResult
+{
+    uint64_t id;     //send() in döndüğü numara
+    uint8_t header;
+    uint8_t seq;
+    CommandStatus status;
+    uint64_t latency_ns;     //çerçevenin yazılmasından ACK_REP in okunmasına kadar
+    uint64_t sent_ns;     //çerçevenin yazıldığı host zamanı, CLOCK_MONOTONIC
+    uint64_t processed_ns;     //MCU da işlendiği host zamanı, saat senkronize değilse veya bilinmiyorsa 0
+};
+
+using CommandCallback = std::function<void (const CommandResult&)>;
+using ReplyCallback = std::function<void (const uart_rep&, uint8_t len)>;
+using TelemetryCallback = std::function<void (const uart_rep&)>;     //her snapshot TELEMETRY_REP olarak verilir
+
+class VehicleClient
+{
+public:
+    explicit VehicleClient (int fd);
+    ~VehicleClient ( );
+    VehicleClient (const VehicleClient&) = delete;
+    VehicleClient& operator= (const VehicleClient&) = delete;
+
+    static int open_serial (const std::string& path, uint32_t baudrate);
+
+    uint64_t send (const uart_req& req, CommandCallback callback = nullptr, uint8_t validity_ms = 0);
+    uint64_t start (CommandCallback callback = nullptr);
+    uint64_t stop (CommandCallback callback = nullptr);
+    uint64_t control (uint8_t steer_dir, uint16_t steer_val, uint8_t throttle, uint8_t brake,
+            CommandCallback callback = nullptr, uint8_t validity_ms = 0);
+    uint64_t sync (CommandCallback callback = nullptr);
+    void on_reply (uint8_t header, ReplyCallback callback);
+    void on_telemetry (TelemetryCallback callback);
+
+    int poll (int timeout_ms);
+    bool run_until_idle (int timeout_ms);
+
+    void set_window (uint8_t window);
+    void set_timeout (std::chrono::milliseconds timeout);
+    void set_flow_control (bool enabled);
+    size_t in_flight ( ) const;
+    size_t queued ( ) const;
+    uint64_t timeout_count ( ) const;
+    uint8_t mcu_queue ( ) const;
+    uint8_t credits ( ) const;
+    uint16_t telemetry_lost_frames ( ) const;
+    LatencyStats& latency ( );
+    LatencyStats& latency (uint8_t header);
+    ClockSync& clock ( );
+    static uint64_t now_ns ( );
+
+private:
+    struct Command
+    {
+        uint64_t id;
+        uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE];
+        uint8_t len;
+        CommandCallback callback;
+    };
+
+    struct Pending
+    {
+        bool waiting = false;
+        uint64_t id;
+        uint8_t header;
+        uint64_t sent_ns;
+        CommandCallback callback;
+    };
+
+    void transmit_queued ( );
+    bool has_credit (const Command& command) const;
+    void flush_tx ( );
+    void update_events ( );
+    void handle_input ( );
+    void handle_ack (const uart_rep& rep);
+    void handle_sync (const uart_rep& rep, uint64_t now);
+    void handle_telemetry (const uint8_t* payload, uint8_t len, const uart_rep& rep);
+    void complete (uint8_t seq, CommandStatus status, uint64_t now, uint64_t processed_ns = 0);
+    void expire (uint64_t now);
+    int next_timeout_ms (int timeout_ms) const;
+
+    int fd_;
+    int epoll_fd_;
+    bool want_write_ = false;
+    uart_frame_parser parser_;
+
+    uint8_t tx_seq_ = 0;
+    uint8_t window_ = UART_ACK_WINDOW;
+    uint64_t next_id_ = 1;
+    uint64_t timeout_ns_ = 1000000000ULL;
+    uint64_t timeout_count_ = 0;
+    size_t in_flight_ = 0;
+    bool flow_control_ = false;
+    uint8_t credit_limit_ = 0xFF;     //MCU nun kabul edeceği en büyük sıra numarası, ilk ACK_REP e kadar yok
+    uint8_t mcu_queue_ = 0;
+
+    std::deque<Command> queue_;
+    std::array<Pending, 256> pending_;
+    std::vector<uint8_t> tx_buffer_;
+    size_t tx_offset_ = 0;
+    std::array<ReplyCallback, UART_HEADER_COUNT> reply_callbacks_;
+    LatencyStats latency_;
+    std::array<LatencyStats, UART_HEADER_COUNT> header_latency_;
+    ClockSync clock_;
+    telemetry_decoder telemetry_decoder_;
+    TelemetryCallback telemetry_callback_;
+};
+
+}     // namespace vehicle
+
+#endif /* HOST_CLIENT_VEHICLE_CLIENT_H_ */
@@ -0,0 +1,234 @@
+/**
+ * \file        link_emu.cpp
+ * \brief       Seri hat emülatörü. İlk kullanımda verilen cihaza (gerçek seri port veya başka bir pty) bağlanır,
+ *              istemcinin bağlanacağı pty yi yazar ve durdurulana kadar byte ları kusurlarla taşır.
+ *              bench modunda firmware deki haberleşme katmanı, MainController ve controllerlar aynı process te
+ *              Host_Codes/shim/posix üzerinde çalışır. VehicleClient emülatör üzerinden her senaryoda CONTROL_REQ
+ *              akışı gönderir, throughput, gidiş-dönüş yüzdelikleri, timeout lar ve firmware in CRC/header hata
+ *              sayaçları yazılır. Bağlantıyı koparan bir senaryo ölçümü bozmasın diye heartbeat supervisor kapatılır.
+ *              QUEUE_LENGTH, QUEUE_SEND_TIMEOUT ve PTY_TRANSPORT_RECEIVE_TIMEOUT (UART_RECEIVE_TIMEOUT un
+ *              karşılığı) derlemede -D ile değiştirilerek aynı senaryolarla karşılaştırılabilir.
+ *
+ *              Kullanım:
+ *                  ./link_emu <device> <baudrate> [latency_us] [jitter_us] [drop_rate] [bit_error_rate]
+ *                  ./link_emu bench [count] [window]
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  INC="-IHost_Codes/shim/posix -IHost_Codes/shim/hal -IHost_Codes/transport -I$FW/Inc -I$FW/Src \
+ *                      -I$FW/Src/Controllers -I$FW/Src/Communications -IHost_Codes/client -IHost_Codes/linkemu"
+ *                  gcc -O2 -std=gnu11 -DUART_FRAME_SOFTWARE_CRC=1 $INC -c Host_Codes/shim/posix/posix_rtos.c \
+ *                      Host_Codes/shim/hal/hal.c Host_Codes/transport/pty_transport.c \
+ *                      $FW/Src/Communications/Communication_Mechanism.c $FW/Src/Communications/UART_Frame.c \
+ *                      $FW/Src/Communications/UART_Message.c $FW/Src/Communications/Flight_Recorder.c \
+ *                      $FW/Src/Communications/Telemetry_Codec.c $FW/Src/Controllers/MainController.c \
+ *                      $FW/Src/Controllers/BrakeController.c $FW/Src/Controllers/ThrottleController.c \
+ *                      $FW/Src/Controllers/SteerController.c $FW/Src/Controllers/HeartbeatSupervisor.c \
+ *                      $FW/Src/helpers.c
+ *                  g++ -O2 -std=c++17 -pthread -DUART_FRAME_SOFTWARE_CRC=1 $INC Host_Codes/linkemu/link_emu.cpp \
+ *                      Host_Codes/linkemu/link_emulator.cpp Host_Codes/client/vehicle_client.cpp \
+ *                      Host_Codes/client/latency_stats.cpp Host_Codes/client/clock_sync.cpp *.o -o link_emu
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "link_emulator.h"
+#include "vehicle_client.h"
+#include "main.h"
+#include "BrakeController.h"
+#include "ThrottleController.h"
+#include "SteerController.h"
+#include "MainController.h"
+#include "Communication_Mechanism.h"
+#include "Sensors/hcsr04.h"
+#include "pty_transport.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define LINK_EMU_DEFAULT_COUNT (1000)     //senaryo başına komut
+#define LINK_EMU_MAX_QUEUED (64)
+#define LINK_EMU_COMMAND_TIMEOUT (200)     //ms, cevapsız komut bu sürede kayıp sayılır
+#define LINK_EMU_IDLE_TIMEOUT (10000)     //ms
+/*------------------------------< Typedefs >----------------------------------*/
+struct LinkScenario
+{
+    const char* name;
+    vehicle::LinkProfile profile;
+};
+/*------------------------------< Constants >---------------------------------*/
+static const LinkScenario scenarios[] = {
+        { "direct", { 0, 0, 0, 0, 0 } },
+        { "115200", { 115200, 0, 0, 0, 0 } },
+        { "115200 +2ms j1ms", { 115200, 2000, 1000, 0, 0 } },
+        { "115200 ber 1e-5", { 115200, 0, 0, 0, 1e-5 } },
+        { "115200 drop 1e-3", { 115200, 0, 0, 1e-3, 0 } },
+        { "115200 bad", { 115200, 5000, 2000, 1e-3, 1e-4 } },
+        { "921600", { 921600, 0, 0, 0, 0 } },
+        { "921600 +1ms j0.5ms", { 921600, 1000, 500, 0, 0 } } };
+/*------------------------------< Prototypes >--------------------------------*/
+static int link_emu_forward (int argc, char** argv);
+static int link_emu_bench (uint32_t count, uint8_t window);
+static int link_emu_open_raw (const char* path);
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0)
+    {
+        return link_emu_bench((argc >= 3) ? strtoul(argv[2], NULL, 0) : LINK_EMU_DEFAULT_COUNT,
+                (argc >= 4) ? (uint8_t) strtoul(argv[3], NULL, 0) : UART_ACK_WINDOW);
+    }
+    if (argc >= 3)
+    {
+        return link_emu_forward(argc, argv);
+    }
+    fprintf(stderr, "usage: %s <device> <baudrate> [latency_us] [jitter_us] [drop_rate] [bit_error_rate]\n"
+            "       %s bench [count] [window]\n", argv[0], argv[0]);
+    return 2;
+}
+
+static int link_emu_forward (int argc, char** argv)
+{
+    vehicle::LinkProfile profile;
+    int fd = link_emu_open_raw(argv[1]);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+    profile.baudrate = strtoul(argv[2], NULL, 0);
+    profile.latency_us = (argc >= 4) ? strtoul(argv[3], NULL, 0) : 0;
+    profile.jitter_us = (argc >= 5) ? strtoul(argv[4], NULL, 0) : 0;
+    profile.drop_rate = (argc >= 6) ? strtod(argv[5], NULL) : 0;
+    profile.bit_error_rate = (argc >= 7) ? strtod(argv[6], NULL) : 0;
+
+    vehicle::LinkEmulator emulator(fd);
+    emulator.set_profile(profile);
+    printf("%s\n", emulator.client_path().c_str());
+    fflush(stdout);
+    while (true)
+    {
+        pause();
+    }
+}
+
+/**
+ * Firmware main.c deki sırayla başlatılır, emülatörün cihaz ucu pty_transport un slave ıdır.
+ * */
+static int link_emu_bench (uint32_t count, uint8_t window)
+{
+    using vehicle::CommandResult;
+    using vehicle::CommandStatus;
+
+    EMERGENCY_STOP_GPIO_Port->IDR |= EMERGENCY_STOP_Pin;     //acil stop butonu basılı değil
+    brake_init();
+    throttle_set_value(SPEED_0);
+    throttle_set_lock(THROTTLE_LOCK);
+    steer_init();
+    communication_init(&pty_transport);
+    main_controller_init();
+
+    int device_fd = link_emu_open_raw(pty_transport_get_slave_name());
+    if (device_fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", pty_transport_get_slave_name(), strerror(errno));
+        return 1;
+    }
+    vehicle::LinkEmulator emulator(device_fd);
+    int fd = vehicle::VehicleClient::open_serial(emulator.client_path(), 115200);
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s: %s\n", emulator.client_path().c_str(), strerror(errno));
+        return 1;
+    }
+
+    vehicle::VehicleClient client(fd);
+    CommandStatus start_status = CommandStatus::Timeout;
+    uart_req heartbeat = { };
+
+    heartbeat.req_packed.header = HEARTBEAT_CONFIG_REQ;
+    uart_set_HEARTBEAT_CONFIG_REQ_timeout(&heartbeat, 0);
+    client.send(heartbeat);
+    client.start([&start_status] (const CommandResult& result) { start_status = result.status; });
+    if (!client.run_until_idle(LINK_EMU_IDLE_TIMEOUT) || start_status != CommandStatus::Ok)
+    {
+        fprintf(stderr, "START was not accepted\n");
+        return 1;
+    }
+    client.set_window(window);
+    client.set_timeout(std::chrono::milliseconds(LINK_EMU_COMMAND_TIMEOUT));
+
+    printf("%u commands per scenario, window %u, timeout %u ms\n", count, window, LINK_EMU_COMMAND_TIMEOUT);
+    printf("%-20s %9s %9s %9s %9s %9s %8s %6s %6s %8s %8s\n", "scenario", "cmd/s", "p50 us", "p90 us", "p99 us",
+            "max us", "timeout", "crc", "header", "dropped", "flipped");
+    for (const LinkScenario& scenario : scenarios)
+    {
+        uint64_t timeouts = client.timeout_count();
+        uint16_t crc_errors = communication_get_diag(DIAG_CRC_ERRORS);
+        uint16_t header_errors = communication_get_diag(DIAG_HEADER_ERRORS);
+        vehicle::LinkCounters up = emulator.counters(vehicle::LinkDirection::Uplink);
+        vehicle::LinkCounters down = emulator.counters(vehicle::LinkDirection::Downlink);
+        struct timespec start;
+        struct timespec end;
+
+        emulator.set_profile(scenario.profile);
+        client.latency(CONTROL_REQ).clear();
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            while (client.queued() >= LINK_EMU_MAX_QUEUED)
+            {
+                client.poll(-1);
+            }
+            client.control(0, (i % 2) ? 100 : 0, CONTROL_THROTTLE_KEEP, CONTROL_BRAKE_KEEP);
+        }
+        client.run_until_idle(LINK_EMU_IDLE_TIMEOUT);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        vehicle::LatencyStats& latency = client.latency(CONTROL_REQ);
+        vehicle::LinkCounters up_end = emulator.counters(vehicle::LinkDirection::Uplink);
+        vehicle::LinkCounters down_end = emulator.counters(vehicle::LinkDirection::Downlink);
+
+        printf("%-20s %9.0f %9.1f %9.1f %9.1f %9.1f %8llu %6u %6u %8llu %8llu\n", scenario.name, count / elapsed,
+                latency.percentile(50) / 1e3, latency.percentile(90) / 1e3, latency.percentile(99) / 1e3,
+                latency.max() / 1e3, (unsigned long long) (client.timeout_count() - timeouts),
+                (uint16_t) (communication_get_diag(DIAG_CRC_ERRORS) - crc_errors),
+                (uint16_t) (communication_get_diag(DIAG_HEADER_ERRORS) - header_errors),
+                (unsigned long long) (up_end.dropped - up.dropped + down_end.dropped - down.dropped),
+                (unsigned long long) (up_end.flipped_bits - up.flipped_bits + down_end.flipped_bits
+                        - down.flipped_bits));
+        fflush(stdout);
+    }
+    return 0;
+}
+
+/*
+ * Sensör yerine geçen fonksiyon.
+ */
+
+extern "C" uint16_t hcsr04_get_distance ( )
+{
+    return 0;
+}
+
+static int link_emu_open_raw (const char* path)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+    if (fd >= 0 && tcgetattr(fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
@@ -0,0 +1,224 @@
+/**
+ * \file        link_emulator.cpp
+ * \brief       Bir cihaz ucu (pty_transport un slave ı veya gerçek seri port) ile yeni açılan bir pty arasında
+ *              byte ları taşır ve her iki yönde aynı hat kusurlarını uygular. İstemci client_path() e bağlanır.
+ *              Her byte baud rate e göre 10 bit sürede hattan çıkar, hat meşgulse sıra bekler. Sonra sabit gecikme
+ *              ve ±jitter eklenir. UART byte ların sırasını değiştirmediği için bir byte kendisinden önceki byte tan
+ *              önce teslim edilmez, jitter bu yüzden byte ları kümeler. Kaybolan byte hattı yine meşgul eder.
+ *              Bit hataları byte teslim edilmeden uygulanır. Rastgele sayılar seed ile tekrarlanabilir.
+ *              Byte lar ayrı bir threadde taşınır, profil çalışırken değiştirilebilir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "link_emulator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <termios.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define LINK_EMULATOR_READ_CHUNK (256)
+#define LINK_EMULATOR_IDLE_WAIT_NS (10000000ULL)     //kuyruk boşken durma isteğine bakma aralığı
+#define LINK_EMULATOR_BLOCKED_WAIT_NS (1000000ULL)     //karşı uç okumadığı için yazılamayan byte lar tekrar denenir
+#define LINK_EMULATOR_BITS_PER_BYTE (10)     //start, 8 veri, stop
+/*------------------------------< Functions >---------------------------------*/
+namespace vehicle
+{
+
+/**
+ * device_fd nin sahipliği alınmaz, fd non-blocking yapılır.
+ * */
+LinkEmulator::LinkEmulator (int device_fd, uint32_t seed) :
+        device_fd_(device_fd), random_(seed), running_(true)
+{
+    struct termios tio;
+    const char* name;
+
+    master_fd_ = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (master_fd_ < 0 || grantpt(master_fd_) != 0 || unlockpt(master_fd_) != 0
+            || (name = ptsname(master_fd_)) == NULL)
+    {
+        throw std::runtime_error(std::string("pty: ") + strerror(errno));
+    }
+    client_path_ = name;
+    slave_fd_ = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (slave_fd_ >= 0 && tcgetattr(slave_fd_, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(slave_fd_, TCSANOW, &tio);
+    }
+    fcntl(master_fd_, F_SETFL, fcntl(master_fd_, F_GETFL) | O_NONBLOCK);
+    fcntl(device_fd_, F_SETFL, fcntl(device_fd_, F_GETFL) | O_NONBLOCK);
+    directions_[(int) LinkDirection::Uplink].in_fd = master_fd_;
+    directions_[(int) LinkDirection::Uplink].out_fd = device_fd_;
+    directions_[(int) LinkDirection::Downlink].in_fd = device_fd_;
+    directions_[(int) LinkDirection::Downlink].out_fd = master_fd_;
+    thread_ = std::thread(&LinkEmulator::run, this);
+}
+
+LinkEmulator::~LinkEmulator ( )
+{
+    running_ = false;
+    thread_.join();
+    close(slave_fd_);
+    close(master_fd_);
+}
+
+const std::string& LinkEmulator::client_path ( ) const
+{
+    return client_path_;
+}
+
+/**
+ * Yeni profil sonraki okunan byte lardan itibaren uygulanır, kuyruktaki byte lar eski zamanlarıyla teslim edilir.
+ * */
+void LinkEmulator::set_profile (const LinkProfile& profile)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_ = profile;
+}
+
+LinkProfile LinkEmulator::profile ( )
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profile_;
+}
+
+LinkCounters LinkEmulator::counters (LinkDirection direction)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directions_[(int) direction].counters;
+}
+
+/**
+ * En yakın teslim zamanına kadar ns çözünürlükte beklenir, 115200 baud ta bir byte ~87 us sürer.
+ * */
+void LinkEmulator::run ( )
+{
+    while (running_)
+    {
+        struct pollfd pfd[2];
+        uint64_t now = now_ns();
+        uint64_t wait = LINK_EMULATOR_IDLE_WAIT_NS;
+        struct timespec timeout;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            Direction& direction = directions_[i];
+
+            deliver(direction, now);
+            if (!direction.queue.empty())
+            {
+                uint64_t due = direction.queue.front().deliver_ns;
+                wait = std::min<uint64_t>(wait, (due > now) ? due - now : LINK_EMULATOR_BLOCKED_WAIT_NS);
+            }
+            pfd[i].fd = direction.in_fd;
+            pfd[i].events = POLLIN;
+            pfd[i].revents = 0;
+        }
+        timeout.tv_sec = wait / 1000000000ULL;
+        timeout.tv_nsec = wait % 1000000000ULL;
+        if (ppoll(pfd, 2, &timeout, NULL) <= 0)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < 2; ++i)
+        {
+            if (pfd[i].revents & POLLIN)
+            {
+                receive(directions_[i], profile_, now_ns());
+            }
+        }
+    }
+}
+
+/**
+ * Okunan byte lara teslim zamanı verilir ve kusurlar uygulanır. mutex_ tutulurken çağrılır.
+ * */
+void LinkEmulator::receive (Direction& direction, const LinkProfile& profile, uint64_t now)
+{
+    uint8_t chunk[LINK_EMULATOR_READ_CHUNK];
+    uint64_t byte_ns = profile.baudrate ? LINK_EMULATOR_BITS_PER_BYTE * 1000000000ULL / profile.baudrate : 0;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<int64_t> jitter(-(int64_t) profile.jitter_us * 1000, (int64_t) profile.jitter_us * 1000);
+    ssize_t len = read(direction.in_fd, chunk, sizeof(chunk));
+
+    for (ssize_t i = 0; i < len; ++i)
+    {
+        Byte byte;
+        int64_t deliver;
+
+        direction.busy_until_ns = std::max(direction.busy_until_ns, now) + byte_ns;
+        ++direction.counters.bytes;
+        if (profile.drop_rate > 0 && chance(random_) < profile.drop_rate)
+        {
+            ++direction.counters.dropped;
+            continue;
+        }
+        byte.value = chunk[i];
+        for (int bit = 0; profile.bit_error_rate > 0 && bit < 8; ++bit)
+        {
+            if (chance(random_) < profile.bit_error_rate)
+            {
+                byte.value ^= 1 << bit;
+                ++direction.counters.flipped_bits;
+            }
+        }
+        deliver = (int64_t) (direction.busy_until_ns + profile.latency_us * 1000ULL)
+                + (profile.jitter_us ? jitter(random_) : 0);
+        byte.deliver_ns = std::max<uint64_t>(std::max<int64_t>(deliver, 0), direction.last_deliver_ns);
+        direction.last_deliver_ns = byte.deliver_ns;
+        direction.queue.push_back(byte);
+    }
+}
+
+/**
+ * Zamanı gelen byte lar LINK_EMULATOR_READ_CHUNK lık parçalarla yazılır. Karşı uç okumuyorsa kalanlar sonraki tura bırakılır.
+ * */
+void LinkEmulator::deliver (Direction& direction, uint64_t now)
+{
+    uint8_t chunk[LINK_EMULATOR_READ_CHUNK];
+
+    while (true)
+    {
+        size_t count = 0;
+
+        while (count < direction.queue.size() && count < sizeof(chunk) && direction.queue[count].deliver_ns <= now)
+        {
+            chunk[count] = direction.queue[count].value;
+            ++count;
+        }
+        if (count == 0)
+        {
+            return;
+        }
+        ssize_t written = write(direction.out_fd, chunk, count);
+        if (written <= 0)
+        {
+            return;
+        }
+        direction.queue.erase(direction.queue.begin(), direction.queue.begin() + written);
+        if ((size_t) written < count)
+        {
+            return;
+        }
+    }
+}
+
+uint64_t LinkEmulator::now_ns ( )
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+}     // namespace vehicle
@@ -0,0 +1,97 @@
+/**
+ * \file        link_emulator.h
+ * \brief       İki uç arasında kötü bir seri hattı taklit eder. Detaylı bilgiyi link_emulator.cpp de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_LINKEMU_LINK_EMULATOR_H_
+#define HOST_LINKEMU_LINK_EMULATOR_H_
+
+/*------------------------------< Includes >----------------------------------*/
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+namespace vehicle
+{
+
+struct LinkProfile
+{
+    uint32_t baudrate = 0;     //0 ise byte lar beklemeden iletilir
+    uint32_t latency_us = 0;     //sabit gecikme
+    uint32_t jitter_us = 0;     //gecikmeye eklenen ±jitter_us lik düzgün dağılımlı sapma
+    double drop_rate = 0;     //byte başına kaybolma olasılığı
+    double bit_error_rate = 0;     //bit başına ters dönme olasılığı
+};
+
+struct LinkCounters
+{
+    uint64_t bytes = 0;
+    uint64_t dropped = 0;
+    uint64_t flipped_bits = 0;
+};
+
+enum class LinkDirection
+{
+    Uplink = 0,     //istemciden cihaza
+    Downlink = 1     //cihazdan istemciye
+};
+
+class LinkEmulator
+{
+public:
+    LinkEmulator (int device_fd, uint32_t seed = 1);
+    ~LinkEmulator ( );
+    LinkEmulator (const LinkEmulator&) = delete;
+    LinkEmulator& operator= (const LinkEmulator&) = delete;
+
+    const std::string& client_path ( ) const;
+    void set_profile (const LinkProfile& profile);
+    LinkProfile profile ( );
+    LinkCounters counters (LinkDirection direction);
+
+private:
+    struct Byte
+    {
+        uint64_t deliver_ns;
+        uint8_t value;
+    };
+
+    struct Direction
+    {
+        int in_fd;
+        int out_fd;
+        std::deque<Byte> queue;
+        uint64_t busy_until_ns = 0;     //hattın son byte ı göndermeyi bitirdiği an
+        uint64_t last_deliver_ns = 0;     //UART byte ları sırasını değiştirmez
+        LinkCounters counters;
+    };
+
+    void run ( );
+    void receive (Direction& direction, const LinkProfile& profile, uint64_t now);
+    void deliver (Direction& direction, uint64_t now);
+    static uint64_t now_ns ( );
+
+    int device_fd_;
+    int master_fd_;
+    int slave_fd_;     //istemci bağlanmadan master read inin POLLHUP ile dönmemesi için açık tutulur
+    std::string client_path_;
+    Direction directions_[2];
+    std::mutex mutex_;
+    LinkProfile profile_;
+    std::mt19937_64 random_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+}     // namespace vehicle
+
+#endif /* HOST_LINKEMU_LINK_EMULATOR_H_ */
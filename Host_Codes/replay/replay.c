@@ -0,0 +1,373 @@
+/**
+ * \file        replay.c
+ * \brief       Flight recorder kayıtlarını araç olmadan bilgisayarda tekrar oynatır.
+ *
+ *              Kaydı almak için (araç 115200 baud da, çerçeveli protokolde):
+ *                  ./replay --capture /dev/ttyACM0 dump.bin
+ *              RECORDER_DUMP_REQ gönderilir, gelen RECORDER_REP kayıtları dump.bin e yazılır.
+ *
+ *              Oynatmak için:
+ *                  ./replay dump.bin
+ *              Firmware deki main_controller_task, Brake/Throttle/Steer controllerlar ve mesaj kodu
+ *              Host_Codes/shim/hal ve Host_Codes/shim/sim altındaki HAL ve sanal zamanlı RTOS yerine
+ *              geçen kodla derlenir. Kayıtlar controllera geliş
+ *              tick lerinde verilir, sanal zaman beklemeden ilerler. Her kayıt için oynatmada çıkan
+ *              ACK sonucu kayıttaki ile karşılaştırılır ve işleme süresi ölçülür.
+ *              Zamana bağlı sonuçlar (süresi dolan komutlar) araçtaki queue beklemesi
+ *              bilinmediği için farklı çıkabilir, bunlar ayrıca listelenir.
+ *
+ *              Derleme (repo kök dizininden):
+ *                  FW=STM32_Codes/autonomousVehicle_GTU
+ *                  gcc -O2 -std=gnu11 -DUART_FRAME_SOFTWARE_CRC=1 -IHost_Codes/shim/sim -IHost_Codes/shim/hal \
+ *                      -I$FW/Inc -I$FW/Src -I$FW/Src/Controllers -I$FW/Src/Communications \
+ *                      Host_Codes/replay/replay.c Host_Codes/shim/sim/sim_rtos.c Host_Codes/shim/hal/hal.c \
+ *                      $FW/Src/Controllers/MainController.c $FW/Src/Controllers/BrakeController.c \
+ *                      $FW/Src/Controllers/ThrottleController.c $FW/Src/Controllers/SteerController.c \
+ *                      $FW/Src/Communications/UART_Message.c $FW/Src/Communications/UART_Frame.c \
+ *                      $FW/Src/helpers.c -o replay
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "main.h"
+#include "cmsis_os.h"
+#include "BrakeController.h"
+#include "ThrottleController.h"
+#include "SteerController.h"
+#include "MainController.h"
+#include "HeartbeatSupervisor.h"
+#include "Communication_Mechanism.h"
+#include "Flight_Recorder.h"
+#include "UART_Frame.h"
+#include "Sensors/hcsr04.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define REPLAY_CAPTURE_TIMEOUT_MS (3000)     //bu sürede yeni byte gelmezse capture bitirilir
+#define REPLAY_MAX_REPORTED_MISMATCHES (20)
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+static flight_recorder_entry* entries;
+static uint32_t entry_count;
+static uint32_t entry_index;     //controllera verilecek bir sonraki kayıt
+static volatile int replay_done;
+
+static struct timespec process_start;
+static uint64_t process_ns_total;
+static uint64_t process_ns_max;
+static uint32_t mismatch_count;
+static uint32_t timing_mismatch_count;
+/*------------------------------< Prototypes >--------------------------------*/
+static int replay_capture (const char* device, const char* path);
+static int replay_run (const char* path);
+static uint8_t replay_is_timing_dependent (const flight_recorder_entry* entry, uint8_t result);
+static uint64_t replay_elapsed_ns (const struct timespec* start);
+/*------------------------------< Functions >---------------------------------*/
+
+int main (int argc, char** argv)
+{
+    if (argc == 4 && strcmp(argv[1], "--capture") == 0)
+    {
+        return replay_capture(argv[2], argv[3]);
+    }
+    if (argc == 2)
+    {
+        return replay_run(argv[1]);
+    }
+    fprintf(stderr, "usage: %s <dump.bin>\n       %s --capture <tty> <dump.bin>\n", argv[0], argv[0]);
+    return 2;
+}
+
+/*
+ * Firmware deki Communication_Mechanism yerine geçen fonksiyonlar.
+ */
+
+Return_Status communication_get_msg (communication_msg* msg)
+{
+    const flight_recorder_entry* entry;
+
+    if (entry_index == entry_count)
+    {
+        replay_done = 1;
+        shim_exit_task( );
+    }
+    entry = &entries[entry_index];
+    shim_wait_until(entry->tick);
+    msg->req = entry->req;
+    msg->seq = entry->seq;
+    msg->validity = entry->validity;
+    msg->arrival_tick = entry->tick;
+    clock_gettime(CLOCK_MONOTONIC, &process_start);
+    return OK;
+}
+
+void communication_ack (uint8_t seq, enum ACK_RESULT result)
+{
+    const flight_recorder_entry* entry = &entries[entry_index++];
+    uint64_t ns = replay_elapsed_ns(&process_start);
+
+    process_ns_total += ns;
+    if (ns > process_ns_max)
+    {
+        process_ns_max = ns;
+    }
+    if (result == entry->result)
+    {
+        return;
+    }
+    if (replay_is_timing_dependent(entry, result))
+    {
+        ++timing_mismatch_count;
+        return;
+    }
+    if (++mismatch_count <= REPLAY_MAX_REPORTED_MISMATCHES)
+    {
+        printf("mismatch #%u tick %u seq %u header %u: recorded %u replayed %u\n", entry_index - 1,
+                entry->tick, entry->seq, entry->req.req_packed.header, entry->result, result);
+    }
+}
+
+uint8_t communication_is_expired (const communication_msg* msg)
+{
+    if (msg->validity == 0)
+    {
+        return 0;
+    }
+    return (xTaskGetTickCount( ) - msg->arrival_tick) > pdMS_TO_TICKS(msg->validity);
+}
+
+Return_Status communication_send_msg (uart_rep* msg)
+{
+    return OK;
+}
+
+void communication_set_ack_interval (uint16_t interval)
+{
+}
+
+Return_Status communication_request_baudrate (uint32_t baudrate)
+{
+    return OK;
+}
+
+void communication_set_telemetry_source (communication_telemetry_source source)
+{
+}
+
+Return_Status communication_set_telemetry_rate (uint16_t rate)
+{
+    return OK;
+}
+
+Return_Status communication_set_telemetry_batch (uint16_t batch)
+{
+    return OK;
+}
+
+uint16_t communication_get_diag (uint16_t counter)
+{
+    return 0;
+}
+
+/*
+ * Kayıtlar sanal zamanda geliş tick lerinde verildiği için heartbeat supervisor çalıştırılmaz.
+ */
+
+Return_Status heartbeat_set_timeout (uint16_t timeout)
+{
+    return OK;
+}
+
+uint8_t heartbeat_is_stopping ( )
+{
+    return 0;
+}
+
+uint16_t heartbeat_get_stop_count ( )
+{
+    return 0;
+}
+
+uint32_t heartbeat_get_latency_max ( )
+{
+    return 0;
+}
+
+void flight_recorder_init ( )
+{
+}
+
+void flight_recorder_record (const communication_msg* msg, enum ACK_RESULT result, uint32_t cycles)
+{
+}
+
+uint16_t flight_recorder_start_dump ( )
+{
+    return 0;
+}
+
+uint16_t hcsr04_get_distance ( )
+{
+    return 0;
+}
+
+/**
+ * Kayıt dosyası flight_recorder_entry lerin arka arkaya yazılmasıdır.
+ * */
+static int replay_run (const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    struct timespec start;
+    uint64_t wall_ns;
+    uint64_t cycles_total = 0;
+    uint32_t cycles_max = 0;
+    uint32_t duration;
+    long size;
+    uint32_t i;
+
+    if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    rewind(file);
+    entry_count = size / sizeof(flight_recorder_entry);
+    entries = malloc(entry_count * sizeof(flight_recorder_entry) + 1);
+    if (entries == NULL || fread(entries, sizeof(flight_recorder_entry), entry_count, file) != entry_count)
+    {
+        fprintf(stderr, "%s: short read\n", path);
+        return 1;
+    }
+    fclose(file);
+    if (entry_count == 0)
+    {
+        printf("empty dump\n");
+        return 0;
+    }
+    for (i = 0; i < entry_count; ++i)
+    {
+        cycles_total += entries[i].cycles;
+        if (entries[i].cycles > cycles_max)
+        {
+            cycles_max = entries[i].cycles;
+        }
+    }
+
+    //Acil durum butonu basılı değil.
+    HAL_GPIO_WritePin(EMERGENCY_STOP_GPIO_Port, EMERGENCY_STOP_Pin, GPIO_PIN_SET);
+    EMERGENCY_STOP_GPIO_Port->IDR |= EMERGENCY_STOP_Pin;
+    is_started = 0;
+    brake_init( );
+    steer_init( );
+    main_controller_init( );
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    shim_run(&replay_done);
+    wall_ns = replay_elapsed_ns(&start);
+
+    duration = entries[entry_count - 1].tick - entries[0].tick;
+    printf("commands          : %u replayed of %u\n", entry_index, entry_count);
+    printf("recorded span     : %u ms\n", duration);
+    printf("wall time         : %.3f ms (%.0fx real time)\n", wall_ns / 1e6,
+            wall_ns ? duration * 1e6 / wall_ns : 0.0);
+    printf("replay cost       : mean %.0f ns, max %llu ns per command\n",
+            entry_index ? (double) process_ns_total / entry_index : 0.0, (unsigned long long) process_ns_max);
+    printf("recorded cost     : mean %.0f cycles, max %u cycles per command\n",
+            (double) cycles_total / entry_count, cycles_max);
+    printf("result mismatches : %u (+%u timing dependent)\n", mismatch_count, timing_mismatch_count);
+    printf("final state       : started %u steer %d throttle %u brake %u\n", is_started, steer_get_value( ),
+            throttle_get_value( ), brake_get_value( ));
+    return mismatch_count ? 3 : 0;
+}
+
+/**
+ * Araçta süresi dolduğu için ERROR dönmüş bir komut oynatmada başarılı olabilir veya tersi.
+ * */
+static uint8_t replay_is_timing_dependent (const flight_recorder_entry* entry, uint8_t result)
+{
+    return entry->validity != 0 && (entry->result == ACK_ERROR || result == ACK_ERROR);
+}
+
+static int replay_capture (const char* device, const char* path)
+{
+    int fd = open(device, O_RDWR | O_NOCTTY);
+    FILE* file;
+    struct termios tio;
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE] = { RECORDER_DUMP_REQ, 0, 0 };
+    uint8_t frame[UART_FRAME_MAX_SIZE];
+    uart_frame_parser parser;
+    uint8_t payload_len;
+    uint8_t seq;
+    uint32_t received = 0;
+    uint8_t byte;
+    uint8_t done = 0;
+    Return_Status status;
+
+    if (fd < 0 || tcgetattr(fd, &tio) != 0)
+    {
+        fprintf(stderr, "%s: %s\n", device, strerror(errno));
+        return 1;
+    }
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B115200);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = REPLAY_CAPTURE_TIMEOUT_MS / 100;
+    tcsetattr(fd, TCSANOW, &tio);
+    tcflush(fd, TCIOFLUSH);
+
+    if ((file = fopen(path, "wb")) == NULL)
+    {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    if (write(fd, frame, uart_frame_encode(payload, UART_REQ_SIZE, 0, frame)) < 0)
+    {
+        fprintf(stderr, "%s: %s\n", device, strerror(errno));
+        return 1;
+    }
+
+    //RECORDER_REP dışındaki çerçeveler (ACK_REP, telemetri) atlanır.
+    uart_frame_parser_init(&parser);
+    while (!done && read(fd, &byte, 1) == 1)
+    {
+        for (status = uart_frame_parse_byte(&parser, byte, payload, &payload_len, &seq); status == OK && !done;
+                status = uart_frame_parse_next(&parser, payload, &payload_len, &seq))
+        {
+            const struct UART_recorder_rep_packed* rep = (const struct UART_recorder_rep_packed*) payload;
+            const flight_recorder_entry* entry = (const flight_recorder_entry*) rep->entry;
+
+            if (payload[0] != RECORDER_REP || payload_len != UART_RECORDER_REP_SIZE)
+            {
+                continue;
+            }
+            if (entry->result != FLIGHT_RECORDER_NO_ENTRY)
+            {
+                fwrite(rep->entry, UART_RECORDER_ENTRY_SIZE, 1, file);
+                ++received;
+            }
+            done = (rep->remaining == 0);
+        }
+    }
+    fclose(file);
+    close(fd);
+    printf("%u records written to %s\n", received, path);
+    return 0;
+}
+
+static uint64_t replay_elapsed_ns (const struct timespec* start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (uint64_t) (end.tv_sec - start->tv_sec) * 1000000000ULL + (end.tv_nsec - start->tv_nsec);
+}
@@ -0,0 +1,123 @@
+/**
+ * \file        hal.c
+ * \brief       Firmware bilgisayarda derlenirken HAL fonksiyonları ve main.c deki global değişkenler
+ *              yerine geçer. Register lar ve pinler sadece bellekte tutulur.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "main.h"
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+GPIO_TypeDef shim_gpio[8];
+TIM_TypeDef shim_tim[15];
+DWT_Type shim_dwt;
+CoreDebug_Type shim_core_debug;
+SysTick_Type shim_systick = { .LOAD = 167999, .VAL = 167999 };     //tick içindeki konum yok, süreler tam tick
+SCB_Type shim_scb;
+uint32_t SystemCoreClock = 168000000;
+
+DAC_HandleTypeDef hdac;
+TIM_HandleTypeDef htim2 = { TIM2 };
+TIM_HandleTypeDef htim3 = { TIM3 };
+TIM_HandleTypeDef htim4 = { TIM4 };
+TIM_HandleTypeDef htim7 = { TIM7 };
+UART_HandleTypeDef huart2;
+volatile uint8_t is_started;
+/*------------------------------< Prototypes >--------------------------------*/
+
+/*------------------------------< Functions >---------------------------------*/
+
+void HAL_GPIO_WritePin (GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET)
+    {
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->ODR &= ~(uint32_t) GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin (GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/**
+ * DWT her kullanıldığında CYCCNT shim_get_cycles( ) ile güncellenir.
+ * */
+DWT_Type* shim_dwt_sync (void)
+{
+    shim_dwt.CYCCNT = shim_get_cycles( );
+    return &shim_dwt;
+}
+
+/**
+ * Varsayılan sayaç sadece yazılan değeri tutar (sanal zamanlı sim shim). Host_Codes/shim/posix bunu
+ * gerçek zamandan SystemCoreClock hızında ilerleyen bir sayaçla değiştirir.
+ * */
+__attribute__((weak)) uint32_t shim_get_cycles (void)
+{
+    return shim_dwt.CYCCNT;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start (TIM_HandleTypeDef* htim, uint32_t Channel)
+{
+    htim->Instance->CCER |= 1U << Channel;
+    htim->Instance->CR1 |= 1U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop (TIM_HandleTypeDef* htim, uint32_t Channel)
+{
+    htim->Instance->CCER &= ~(1U << Channel);
+    htim->Instance->CR1 &= ~1U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT (TIM_HandleTypeDef* htim)
+{
+    htim->Instance->DIER |= 1U;
+    htim->Instance->CR1 |= 1U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop (TIM_HandleTypeDef* htim)
+{
+    htim->Instance->CR1 &= ~1U;
+    return HAL_OK;
+}
+
+/**
+ * Registerlar düz bellek olduğu için UG nin yükleyeceği preload yoktur. Timer ı modelleyen sim
+ * shim_tim_event( ) i değiştirip aktif registerlarını burada günceller.
+ * */
+__attribute__((weak)) void shim_tim_event (TIM_TypeDef* tim, uint32_t event)
+{
+    if (event & TIM_EGR_UG)
+    {
+        tim->CNT = 0;
+        tim->SR |= TIM_SR_UIF;
+    }
+}
+
+HAL_StatusTypeDef HAL_TIM_GenerateEvent (TIM_HandleTypeDef* htim, uint32_t EventSource)
+{
+    htim->Instance->EGR = EventSource;
+    shim_tim_event(htim->Instance, EventSource);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DAC_SetValue (DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t Alignment, uint32_t Data)
+{
+    return HAL_OK;
+}
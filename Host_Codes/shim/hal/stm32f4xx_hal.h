@@ -0,0 +1,199 @@
+/**
+ * \file        stm32f4xx_hal.h
+ * \brief       Host araçları için HAL yerine geçen header. Firmware deki controllerlar bilgisayarda
+ *              derlenirken STM32 HAL yerine bu dosya kullanılır. Register lar gerçek adreslere değil
+ *              hal.c deki değişkenlere yazılır, HAL fonksiyonları sadece durumu kaydeder.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_SHIM_HAL_STM32F4XX_HAL_H_
+#define HOST_SHIM_HAL_STM32F4XX_HAL_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define __IO volatile
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+#define GPIOA (&shim_gpio[0])
+#define GPIOB (&shim_gpio[1])
+#define GPIOC (&shim_gpio[2])
+#define GPIOD (&shim_gpio[3])
+#define GPIOE (&shim_gpio[4])
+#define GPIOH (&shim_gpio[7])
+
+#define TIM1 (&shim_tim[1])
+#define TIM2 (&shim_tim[2])
+#define TIM3 (&shim_tim[3])
+#define TIM4 (&shim_tim[4])
+#define TIM7 (&shim_tim[7])
+#define TIM8 (&shim_tim[8])
+
+#define TIM_CR1_CEN     (0x0001U)
+#define TIM_DIER_UIE    (0x0001U)
+#define TIM_DIER_CC1IE  (0x0002U)
+#define TIM_SR_UIF      (0x0001U)
+#define TIM_SR_CC1IF    (0x0002U)
+#define TIM_EGR_UG      (0x0001U)
+
+#define TIM_EVENTSOURCE_UPDATE TIM_EGR_UG
+
+#define TIM_CHANNEL_1 (0x00000000U)
+#define TIM_CHANNEL_2 (0x00000004U)
+#define TIM_CHANNEL_3 (0x00000008U)
+#define TIM_CHANNEL_4 (0x0000000CU)
+
+#define DAC_CHANNEL_1   (0x00000000U)
+#define DAC_CHANNEL_2   (0x00000010U)
+#define DAC_ALIGN_12B_R (0x00000000U)
+
+#define DWT (shim_dwt_sync( ))
+#define CoreDebug (&shim_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+#define SysTick (&shim_systick)
+#define SCB (&shim_scb)
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+/*------------------------------< Typedefs >----------------------------------*/
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SMCR;
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO uint32_t EGR;
+    __IO uint32_t CCMR1;
+    __IO uint32_t CCMR2;
+    __IO uint32_t CCER;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+    __IO uint32_t RCR;
+    __IO uint32_t CCR1;
+    __IO uint32_t CCR2;
+    __IO uint32_t CCR3;
+    __IO uint32_t CCR4;
+    __IO uint32_t BDTR;
+} TIM_TypeDef;
+
+typedef struct
+{
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+    void* Instance;
+} DAC_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct
+{
+    void* Instance;
+    UART_InitTypeDef Init;
+} UART_HandleTypeDef;
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __IO uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+    __IO uint32_t ICSR;
+} SCB_Type;
+/*------------------------------< Constants >---------------------------------*/
+extern GPIO_TypeDef shim_gpio[8];
+extern TIM_TypeDef shim_tim[15];
+extern DWT_Type shim_dwt;
+extern CoreDebug_Type shim_core_debug;
+extern SysTick_Type shim_systick;
+extern SCB_Type shim_scb;
+extern uint32_t SystemCoreClock;
+/*------------------------------< Prototypes >--------------------------------*/
+DWT_Type* shim_dwt_sync (void);
+uint32_t shim_get_cycles (void);
+void HAL_GPIO_WritePin (GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin (GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+HAL_StatusTypeDef HAL_TIM_PWM_Start (TIM_HandleTypeDef* htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop (TIM_HandleTypeDef* htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT (TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop (TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_GenerateEvent (TIM_HandleTypeDef* htim, uint32_t EventSource);
+void shim_tim_event (TIM_TypeDef* tim, uint32_t event);
+HAL_StatusTypeDef HAL_DAC_SetValue (DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t Alignment, uint32_t Data);
+
+static inline uint32_t ITM_SendChar (uint32_t ch)
+{
+    putchar((int) ch);
+    return ch;
+}
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* HOST_SHIM_HAL_STM32F4XX_HAL_H_ */
@@ -0,0 +1,14 @@
+/**
+ * \file        stm32f4xx_hal_gpio.h
+ * \brief       GPIO tanımları stm32f4xx_hal.h içindedir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_SHIM_HAL_STM32F4XX_HAL_GPIO_H_
+#define HOST_SHIM_HAL_STM32F4XX_HAL_GPIO_H_
+
+#include "stm32f4xx_hal.h"
+
+#endif /* HOST_SHIM_HAL_STM32F4XX_HAL_GPIO_H_ */
@@ -0,0 +1,124 @@
+/**
+ * \file        cmsis_os.h
+ * \brief       Firmware deki haberleşme katmanını bilgisayarda gerçek zamanda çalıştırmak için
+ *              CMSIS-RTOS/FreeRTOS yerine geçen header. Threadler pthread, queue ve semaphore lar
+ *              mutex ve condition variable ile gerçeklenir. Tick 1 ms dir ve CLOCK_MONOTONIC ten okunur.
+ *              Thread öncelikleri uygulanmaz, critical section lar tek bir global mutex ile korunur.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_SHIM_POSIX_CMSIS_OS_H_
+#define HOST_SHIM_POSIX_CMSIS_OS_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define pdTRUE  (1)
+#define pdFALSE (0)
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFU)
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+#define configTICK_RATE_HZ ((TickType_t) 1000)
+#define osWaitForever (0xFFFFFFFFU)
+
+#define taskENTER_CRITICAL() posix_enter_critical( )
+#define taskEXIT_CRITICAL() posix_exit_critical( )
+
+#define osThreadStaticDef(name, thread, priority, instances, stacksz, buffer, control) \
+const osThreadDef_t os_thread_def_##name = { #name, (thread), (priority), (instances), (stacksz) }
+#define osThread(name) &os_thread_def_##name
+/*------------------------------< Typedefs >----------------------------------*/
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+typedef enum
+{
+    osPriorityIdle = -3,
+    osPriorityLow = -2,
+    osPriorityBelowNormal = -1,
+    osPriorityNormal = 0,
+    osPriorityAboveNormal = +1,
+    osPriorityHigh = +2,
+    osPriorityRealtime = +3
+} osPriority;
+
+typedef enum
+{
+    osOK = 0,
+    osErrorOS = 0xFF
+} osStatus;
+
+typedef void (*os_pthread) (void const* argument);
+
+typedef struct
+{
+    const char* name;
+    os_pthread pthread;
+    osPriority tpriority;
+    uint32_t instances;
+    uint32_t stacksize;
+} osThreadDef_t;
+
+struct POSIX_TASK;
+typedef struct POSIX_TASK* osThreadId;
+typedef struct
+{
+    uint8_t unused;
+} osStaticThreadDef_t;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t max;
+} StaticSemaphore_t;
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+typedef SemaphoreHandle_t osSemaphoreId;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t* storage;
+    uint32_t length;
+    uint32_t item_size;
+    uint32_t head;     //bir sonraki okunacak elemanın indexi
+    uint32_t count;
+} StaticQueue_t;
+typedef StaticQueue_t* QueueHandle_t;
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+osThreadId osThreadCreate (const osThreadDef_t* thread_def, void* argument);
+osStatus osDelay (uint32_t millisec);
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec);
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic (uint32_t max, uint32_t initial, StaticSemaphore_t* buffer);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic (StaticSemaphore_t* buffer);
+BaseType_t xSemaphoreTake (SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive (SemaphoreHandle_t semaphore);
+QueueHandle_t xQueueCreateStatic (UBaseType_t length, UBaseType_t item_size, uint8_t* storage,
+        StaticQueue_t* buffer);
+BaseType_t xQueueSend (QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueReceive (QueueHandle_t queue, void* item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue);
+TickType_t xTaskGetTickCount (void);
+
+void posix_enter_critical (void);
+void posix_exit_critical (void);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* HOST_SHIM_POSIX_CMSIS_OS_H_ */
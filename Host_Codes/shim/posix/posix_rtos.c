@@ -0,0 +1,309 @@
+/**
+ * \file        posix_rtos.c
+ * \brief       cmsis_os.h deki RTOS fonksiyonlarının pthread ile gerçeklenmesi.
+ *              Her bekleme CLOCK_MONOTONIC e göre mutlak bir zamana kadar yapılır. Tick sayacı
+ *              ilk çağrıdan itibaren geçen ms dir, 32 bit taşması firmware deki gibi farkla karşılaştırılır.
+ *              Firmware kodunda bloklayan bir queue/semaphore çağrısı critical section içinde yapılmadığı için
+ *              global critical mutex ile nesnelerin kendi mutexleri arasında kilitlenme oluşmaz.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#define _GNU_SOURCE
+#include "cmsis_os.h"
+#include "stm32f4xx_hal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+struct POSIX_TASK
+{
+    pthread_t thread;
+    os_pthread function;
+    void* argument;
+};
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+static pthread_mutex_t critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_once_t clock_once = PTHREAD_ONCE_INIT;
+static struct timespec start_time;
+static pthread_condattr_t cond_attr;
+/*------------------------------< Prototypes >--------------------------------*/
+static void posix_clock_init (void);
+static void* posix_task_entry (void* argument);
+static void posix_cond_init (pthread_cond_t* cond);
+static void posix_deadline (TickType_t ticks, struct timespec* deadline);
+static int posix_wait (pthread_cond_t* cond, pthread_mutex_t* lock, TickType_t ticks,
+        const struct timespec* deadline);
+/*------------------------------< Functions >---------------------------------*/
+
+/**
+ * Öncelik ve stack boyutu kullanılmaz, thread sistemin varsayılan ayarlarıyla oluşturulur.
+ * */
+osThreadId osThreadCreate (const osThreadDef_t* thread_def, void* argument)
+{
+    struct POSIX_TASK* task = calloc(1, sizeof(struct POSIX_TASK));
+
+    if (task == NULL)
+    {
+        return NULL;
+    }
+    task->function = thread_def->pthread;
+    task->argument = argument;
+    if (pthread_create(&task->thread, NULL, posix_task_entry, task) != 0)
+    {
+        free(task);
+        return NULL;
+    }
+    pthread_detach(task->thread);
+    return task;
+}
+
+osStatus osDelay (uint32_t millisec)
+{
+    struct timespec delay = { millisec / 1000, (long) (millisec % 1000) * 1000000L };
+
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR)
+    {
+    }
+    return osOK;
+}
+
+/**
+ * Semaphore alınırsa 0, süre dolarsa -1 döner.
+ * */
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec)
+{
+    return (xSemaphoreTake(semaphore_id, millisec) == pdTRUE) ? 0 : -1;
+}
+
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id)
+{
+    xSemaphoreGive(semaphore_id);
+    return osOK;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic (uint32_t max, uint32_t initial, StaticSemaphore_t* buffer)
+{
+    pthread_mutex_init(&buffer->lock, NULL);
+    posix_cond_init(&buffer->cond);
+    buffer->max = max;
+    buffer->count = initial;
+    return buffer;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic (StaticSemaphore_t* buffer)
+{
+    return xSemaphoreCreateCountingStatic(1, 0, buffer);
+}
+
+BaseType_t xSemaphoreTake (SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+    struct timespec deadline;
+    BaseType_t ret_val = pdFALSE;
+
+    posix_deadline(ticks, &deadline);
+    pthread_mutex_lock(&semaphore->lock);
+    while (semaphore->count == 0)
+    {
+        if (posix_wait(&semaphore->cond, &semaphore->lock, ticks, &deadline) != 0)
+        {
+            break;
+        }
+    }
+    if (semaphore->count != 0)
+    {
+        --semaphore->count;
+        ret_val = pdTRUE;
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return ret_val;
+}
+
+BaseType_t xSemaphoreGive (SemaphoreHandle_t semaphore)
+{
+    BaseType_t ret_val = pdFALSE;
+
+    pthread_mutex_lock(&semaphore->lock);
+    if (semaphore->count < semaphore->max)
+    {
+        ++semaphore->count;
+        ret_val = pdTRUE;
+        pthread_cond_signal(&semaphore->cond);
+    }
+    pthread_mutex_unlock(&semaphore->lock);
+    return ret_val;
+}
+
+QueueHandle_t xQueueCreateStatic (UBaseType_t length, UBaseType_t item_size, uint8_t* storage,
+        StaticQueue_t* buffer)
+{
+    pthread_mutex_init(&buffer->lock, NULL);
+    posix_cond_init(&buffer->not_empty);
+    posix_cond_init(&buffer->not_full);
+    buffer->storage = storage;
+    buffer->length = length;
+    buffer->item_size = item_size;
+    buffer->head = 0;
+    buffer->count = 0;
+    return buffer;
+}
+
+BaseType_t xQueueSend (QueueHandle_t queue, const void* item, TickType_t ticks)
+{
+    struct timespec deadline;
+    BaseType_t ret_val = pdFALSE;
+
+    posix_deadline(ticks, &deadline);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length)
+    {
+        if (posix_wait(&queue->not_full, &queue->lock, ticks, &deadline) != 0)
+        {
+            break;
+        }
+    }
+    if (queue->count < queue->length)
+    {
+        memcpy(&queue->storage[((queue->head + queue->count) % queue->length) * queue->item_size], item,
+                queue->item_size);
+        ++queue->count;
+        ret_val = pdTRUE;
+        pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return ret_val;
+}
+
+BaseType_t xQueueReceive (QueueHandle_t queue, void* item, TickType_t ticks)
+{
+    struct timespec deadline;
+    BaseType_t ret_val = pdFALSE;
+
+    posix_deadline(ticks, &deadline);
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0)
+    {
+        if (posix_wait(&queue->not_empty, &queue->lock, ticks, &deadline) != 0)
+        {
+            break;
+        }
+    }
+    if (queue->count != 0)
+    {
+        memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        --queue->count;
+        ret_val = pdTRUE;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return ret_val;
+}
+
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue)
+{
+    UBaseType_t count;
+
+    pthread_mutex_lock(&queue->lock);
+    count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+TickType_t xTaskGetTickCount (void)
+{
+    struct timespec now;
+
+    pthread_once(&clock_once, posix_clock_init);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (TickType_t) ((now.tv_sec - start_time.tv_sec) * 1000 + (now.tv_nsec - start_time.tv_nsec) / 1000000);
+}
+
+/**
+ * DWT CYCCNT in yerine geçer. Tick sayacı ile aynı başlangıçtan SystemCoreClock hızında sayar,
+ * firmware deki gibi 32 bit taşar.
+ * */
+uint32_t shim_get_cycles (void)
+{
+    struct timespec now;
+    uint64_t ns;
+
+    pthread_once(&clock_once, posix_clock_init);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ns = (uint64_t) (now.tv_sec - start_time.tv_sec) * 1000000000ULL + now.tv_nsec - start_time.tv_nsec;
+    return (uint32_t) (ns * (SystemCoreClock / 1000000) / 1000);
+}
+
+void posix_enter_critical (void)
+{
+    pthread_mutex_lock(&critical_lock);
+}
+
+void posix_exit_critical (void)
+{
+    pthread_mutex_unlock(&critical_lock);
+}
+
+static void posix_clock_init (void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+}
+
+static void* posix_task_entry (void* argument)
+{
+    struct POSIX_TASK* task = argument;
+
+    task->function(task->argument);
+    return NULL;
+}
+
+static void posix_cond_init (pthread_cond_t* cond)
+{
+    pthread_once(&clock_once, posix_clock_init);
+    pthread_cond_init(cond, &cond_attr);
+}
+
+/**
+ * ticks portMAX_DELAY ise deadline kullanılmaz.
+ * */
+static void posix_deadline (TickType_t ticks, struct timespec* deadline)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ticks / 1000;
+    deadline->tv_nsec += (long) (ticks % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        ++deadline->tv_sec;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * ticks 0 ise beklemeden, deadline geçtiyse ETIMEDOUT döner.
+ * */
+static int posix_wait (pthread_cond_t* cond, pthread_mutex_t* lock, TickType_t ticks,
+        const struct timespec* deadline)
+{
+    if (ticks == 0)
+    {
+        return ETIMEDOUT;
+    }
+    if (ticks == portMAX_DELAY)
+    {
+        return pthread_cond_wait(cond, lock);
+    }
+    return pthread_cond_timedwait(cond, lock, deadline);
+}
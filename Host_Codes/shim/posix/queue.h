@@ -0,0 +1,15 @@
+/**
+ * \file        queue.h
+ * \brief       FreeRTOS queue.h yerine geçer, queue fonksiyonları cmsis_os.h de tanımlıdır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_SHIM_POSIX_QUEUE_H_
+#define HOST_SHIM_POSIX_QUEUE_H_
+
+/*------------------------------< Includes >----------------------------------*/
+#include "cmsis_os.h"
+
+#endif /* HOST_SHIM_POSIX_QUEUE_H_ */
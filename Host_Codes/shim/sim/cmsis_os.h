@@ -0,0 +1,101 @@
+/**
+ * \file        cmsis_os.h
+ * \brief       Replay için CMSIS-RTOS/FreeRTOS yerine geçen header. Threadler sim_rtos.c deki sanal zamanlı
+ *              bir scheduler da ucontext ile çalışır. osDelay ve semaphore beklemeleri gerçekten beklemez,
+ *              sanal zaman bir sonraki olayın tick ine atlatılır. Böylece kayıt gerçek zamandan çok daha
+ *              hızlı oynatılır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_SHIM_SIM_CMSIS_OS_H_
+#define HOST_SHIM_SIM_CMSIS_OS_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define pdTRUE  (1)
+#define pdFALSE (0)
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFU)
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+#define configTICK_RATE_HZ ((TickType_t) 1000)
+#define osWaitForever (0xFFFFFFFFU)
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#define osThreadStaticDef(name, thread, priority, instances, stacksz, buffer, control) \
+const osThreadDef_t os_thread_def_##name = { #name, (thread), (priority), (instances), (stacksz) }
+#define osThread(name) &os_thread_def_##name
+/*------------------------------< Typedefs >----------------------------------*/
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+
+typedef enum
+{
+    osPriorityIdle = -3,
+    osPriorityLow = -2,
+    osPriorityBelowNormal = -1,
+    osPriorityNormal = 0,
+    osPriorityAboveNormal = +1,
+    osPriorityHigh = +2,
+    osPriorityRealtime = +3
+} osPriority;
+
+typedef enum
+{
+    osOK = 0,
+    osErrorOS = 0xFF
+} osStatus;
+
+typedef void (*os_pthread) (void const* argument);
+
+typedef struct
+{
+    const char* name;
+    os_pthread pthread;
+    osPriority tpriority;
+    uint32_t instances;
+    uint32_t stacksize;
+} osThreadDef_t;
+
+struct SHIM_TASK;
+typedef struct SHIM_TASK* osThreadId;
+typedef struct
+{
+    uint8_t unused;
+} osStaticThreadDef_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t max;
+} StaticSemaphore_t;
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+typedef SemaphoreHandle_t osSemaphoreId;
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+osThreadId osThreadCreate (const osThreadDef_t* thread_def, void* argument);
+osStatus osDelay (uint32_t millisec);
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec);
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic (uint32_t max, uint32_t initial, StaticSemaphore_t* buffer);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic (StaticSemaphore_t* buffer);
+TickType_t xTaskGetTickCount (void);
+
+void shim_wait_until (TickType_t tick);
+void shim_exit_task (void);
+void shim_run (const volatile int* done);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* HOST_SHIM_SIM_CMSIS_OS_H_ */
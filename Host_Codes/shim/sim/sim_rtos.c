@@ -0,0 +1,219 @@
+/**
+ * \file        sim_rtos.c
+ * \brief       Replay için CMSIS-RTOS/FreeRTOS yerine geçen sanal zamanlı scheduler.
+ *              Her thread kendi ucontext inde çalışır. Scheduler hazır threadlerden en yüksek öncelikliyi
+ *              çalıştırır. Hazır thread yoksa sanal zaman en yakın uyanma tick ine atlatılır.
+ *              Threadler sadece bekleme noktalarında (osDelay, osSemaphoreWait, shim_wait_until)
+ *              bırakır, yani RTOS taki preemption birebir taklit edilmez.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "cmsis_os.h"
+#include <stdlib.h>
+#include <ucontext.h>
+#include <string.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define SHIM_MAX_TASKS  (8)
+#define SHIM_STACK_SIZE (256 * 1024)
+/*------------------------------< Typedefs >----------------------------------*/
+enum SHIM_TASK_STATE
+{
+    SHIM_TASK_READY = 0,
+    SHIM_TASK_DELAYED,
+    SHIM_TASK_WAITING,
+    SHIM_TASK_FINISHED
+};
+
+struct SHIM_TASK
+{
+    ucontext_t context;
+    os_pthread function;
+    void* argument;
+    osPriority priority;
+    enum SHIM_TASK_STATE state;
+    TickType_t wake_tick;
+    SemaphoreHandle_t semaphore;
+    uint8_t stack[SHIM_STACK_SIZE];
+};
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+static struct SHIM_TASK* tasks[SHIM_MAX_TASKS];
+static uint8_t task_count;
+static struct SHIM_TASK* current;
+static ucontext_t scheduler_context;
+static TickType_t now;
+/*------------------------------< Prototypes >--------------------------------*/
+static void shim_task_entry (void);
+static void shim_block (void);
+static uint8_t shim_is_runnable (const struct SHIM_TASK* task);
+/*------------------------------< Functions >---------------------------------*/
+
+osThreadId osThreadCreate (const osThreadDef_t* thread_def, void* argument)
+{
+    struct SHIM_TASK* task;
+
+    if (task_count == SHIM_MAX_TASKS || (task = calloc(1, sizeof(struct SHIM_TASK))) == NULL)
+    {
+        return NULL;
+    }
+    task->function = thread_def->pthread;
+    task->argument = argument;
+    task->priority = thread_def->tpriority;
+    task->state = SHIM_TASK_READY;
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack;
+    task->context.uc_stack.ss_size = sizeof(task->stack);
+    task->context.uc_link = &scheduler_context;
+    makecontext(&task->context, shim_task_entry, 0);
+    tasks[task_count++] = task;
+    return task;
+}
+
+osStatus osDelay (uint32_t millisec)
+{
+    shim_wait_until(now + millisec);
+    return osOK;
+}
+
+/**
+ * Semaphore alınırsa 0, süre dolarsa -1 döner.
+ * */
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec)
+{
+    if (semaphore_id->count == 0 && millisec != 0)
+    {
+        current->state = SHIM_TASK_WAITING;
+        current->semaphore = semaphore_id;
+        current->wake_tick = (millisec == osWaitForever) ? portMAX_DELAY : now + millisec;
+        shim_block( );
+    }
+    if (semaphore_id->count == 0)
+    {
+        return -1;
+    }
+    --semaphore_id->count;
+    return 0;
+}
+
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id)
+{
+    if (semaphore_id->count < semaphore_id->max)
+    {
+        ++semaphore_id->count;
+    }
+    return osOK;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic (uint32_t max, uint32_t initial, StaticSemaphore_t* buffer)
+{
+    buffer->max = max;
+    buffer->count = initial;
+    return buffer;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic (StaticSemaphore_t* buffer)
+{
+    return xSemaphoreCreateCountingStatic(1, 0, buffer);
+}
+
+TickType_t xTaskGetTickCount (void)
+{
+    return now;
+}
+
+/**
+ * Çağıran threadi sanal zaman tick e gelene kadar bekletir.
+ * */
+void shim_wait_until (TickType_t tick)
+{
+    if ((int32_t) (tick - now) <= 0)
+    {
+        return;
+    }
+    current->state = SHIM_TASK_DELAYED;
+    current->wake_tick = tick;
+    shim_block( );
+}
+
+/**
+ * Çağıran thread bir daha çalıştırılmaz.
+ * */
+void shim_exit_task (void)
+{
+    current->state = SHIM_TASK_FINISHED;
+    shim_block( );
+}
+
+/**
+ * done 0 dan farklı olana veya çalışabilecek thread kalmayana kadar threadleri çalıştırır.
+ * */
+void shim_run (const volatile int* done)
+{
+    uint8_t i;
+
+    while (!*done)
+    {
+        struct SHIM_TASK* next = NULL;
+        TickType_t next_wake = portMAX_DELAY;
+
+        for (i = 0; i < task_count; ++i)
+        {
+            if (shim_is_runnable(tasks[i]) && (next == NULL || tasks[i]->priority > next->priority))
+            {
+                next = tasks[i];
+            }
+        }
+        if (next != NULL)
+        {
+            next->state = SHIM_TASK_READY;
+            current = next;
+            swapcontext(&scheduler_context, &next->context);
+            current = NULL;
+            continue;
+        }
+        for (i = 0; i < task_count; ++i)
+        {
+            if ((tasks[i]->state == SHIM_TASK_DELAYED || tasks[i]->state == SHIM_TASK_WAITING)
+                    && tasks[i]->wake_tick < next_wake)
+            {
+                next_wake = tasks[i]->wake_tick;
+            }
+        }
+        if (next_wake == portMAX_DELAY)
+        {
+            return;
+        }
+        now = next_wake;
+    }
+}
+
+static void shim_task_entry (void)
+{
+    current->function(current->argument);
+    current->state = SHIM_TASK_FINISHED;
+}
+
+static void shim_block (void)
+{
+    swapcontext(&current->context, &scheduler_context);
+}
+
+static uint8_t shim_is_runnable (const struct SHIM_TASK* task)
+{
+    switch (task->state)
+    {
+        case SHIM_TASK_READY:
+            return 1;
+        case SHIM_TASK_DELAYED:
+            return (int32_t) (task->wake_tick - now) <= 0;
+        case SHIM_TASK_WAITING:
+            return task->semaphore->count > 0
+                    || (task->wake_tick != portMAX_DELAY && (int32_t) (task->wake_tick - now) <= 0);
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,203 @@
+/**
+ * \file        can_transport.c
+ * \brief       Firmware deki haberleşme katmanını Linux SocketCAN üzerinden çalıştırır (vcan veya gerçek
+ *              bir CAN arayüzü). Çerçeveli protokolün byte akışı en fazla 8 byte lık CAN frame lerine
+ *              bölünür, hosttan gelenler rx_id, araçtan gidenler tx_id ile gönderilir.
+ *              UART_Frame SOF ve CRC ile akıştan tekrar senkronize olduğu için CAN frame sınırlarının
+ *              çerçeve sınırlarıyla örtüşmesi gerekmez.
+ *              Bit hızı arayüz açılırken (ip link) belirlendiği için BAUD_REQ reddedilir.
+ *
+ *              vcan ile denemek için:
+ *                  ip link add dev vcan0 type vcan && ip link set up vcan0
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#define _GNU_SOURCE
+#include "can_transport.h"
+#include "helpers.h"
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define CAN_TRANSPORT_RETRY_INTERVAL (100)     //us, 500 kbit/s te yaklaşık bir frame süresi
+#define CAN_TRANSPORT_TRANSMIT_RETRIES (CAN_TRANSPORT_TRANSMIT_TIMEOUT * 1000 / CAN_TRANSPORT_RETRY_INTERVAL)
+
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+static void can_transport_init ( );
+static void can_transport_transmit (const uint8_t* msg, uint8_t msg_len);
+static Return_Status can_transport_receive (uint8_t* msg, uint8_t msg_len);
+static uint16_t can_transport_read (uint8_t* buf, uint16_t max_len);
+static uint32_t can_transport_get_rx_cycle ( );
+/*------------------------------< Constants >---------------------------------*/
+const transport can_transport =
+{
+    .init = can_transport_init,
+    .transmit = can_transport_transmit,
+    .receive = can_transport_receive,
+    .read = can_transport_read,
+    .get_rx_cycle = can_transport_get_rx_cycle,
+    .set_baudrate = NULL,
+    .is_baudrate_supported = NULL,
+    .default_baudrate = 0,
+    .get_error_count = NULL,
+};
+/*------------------------------< Variables >---------------------------------*/
+static const char* can_ifname = "vcan0";
+static uint32_t can_rx_id = CAN_TRANSPORT_DEFAULT_RX_ID;
+static uint32_t can_tx_id = CAN_TRANSPORT_DEFAULT_TX_ID;
+static int can_fd = -1;
+static volatile uint32_t rx_cycle;
+
+static uint8_t pending[CAN_MAX_DLEN];     //read e sığmayan, bir sonraki read de dönülecek byte lar
+static uint8_t pending_index;
+static uint8_t pending_len;
+/*------------------------------< Functions >---------------------------------*/
+
+/**
+ * communication_init den önce çağrılmalıdır.
+ * */
+void can_transport_configure (const char* ifname, uint32_t rx_id, uint32_t tx_id)
+{
+    can_ifname = ifname;
+    can_rx_id = rx_id;
+    can_tx_id = tx_id;
+}
+
+/**
+ * ifname e bağlı, sadece rx_id li frameleri alan bir raw CAN soketi açar. Hata olursa -1 döner.
+ * Host tarafındaki istemciler de aynı fonksiyonu id leri ters vererek kullanır.
+ * */
+int can_transport_open_socket (const char* ifname, uint32_t rx_id)
+{
+    struct sockaddr_can addr = { 0 };
+    struct can_filter filter = { rx_id, CAN_SFF_MASK };
+    int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = if_nametoindex(ifname);
+    if (addr.can_ifindex == 0 || setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) != 0
+            || bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void can_transport_init ( )
+{
+    if ((can_fd = can_transport_open_socket(can_ifname, can_rx_id)) < 0)
+    {
+        perror(can_ifname);
+        exit(1);
+    }
+}
+
+/**
+ * msg i id ile CAN frame lerine bölerek fd ye yazar. Soketin veya arayüzün TX queue su doluysa (EAGAIN,
+ * ENOBUFS) frame CAN_TRANSPORT_RETRY_INTERVAL aralıkla tekrar yazılır. SocketCAN ENOBUFS ten sonra POLLOUT u
+ * hemen verdiği için poll ile beklenmez. Bus CAN_TRANSPORT_TRANSMIT_TIMEOUT boyunca bir frame i bile almazsa
+ * (örneğin ACK veren düğüm yoksa) çerçevenin kalanı atılır, karşı taraf eksik çerçeveyi CRC ile atar ve NOK döner.
+ * Host tarafındaki istemciler de aynı fonksiyonu kullanır.
+ * */
+Return_Status can_transport_send (int fd, uint32_t id, const uint8_t* msg, uint8_t msg_len)
+{
+    struct can_frame frame = { 0 };
+    struct timespec delay = { 0, CAN_TRANSPORT_RETRY_INTERVAL * 1000 };
+    uint32_t retries = 0;
+
+    frame.can_id = id;
+    while (msg_len > 0)
+    {
+        frame.can_dlc = (msg_len < CAN_MAX_DLEN) ? msg_len : CAN_MAX_DLEN;
+        memcpy(frame.data, msg, frame.can_dlc);
+        if (write(fd, &frame, sizeof(frame)) != sizeof(frame))
+        {
+            if ((errno != ENOBUFS && errno != EAGAIN && errno != EINTR) || retries == CAN_TRANSPORT_TRANSMIT_RETRIES)
+            {
+                return NOK;
+            }
+            ++retries;
+            nanosleep(&delay, NULL);
+            continue;
+        }
+        retries = 0;
+        msg += frame.can_dlc;
+        msg_len -= frame.can_dlc;
+    }
+    return OK;
+}
+
+static void can_transport_transmit (const uint8_t* msg, uint8_t msg_len)
+{
+    can_transport_send(can_fd, can_tx_id, msg, msg_len);
+}
+
+static Return_Status can_transport_receive (uint8_t* msg, uint8_t msg_len)
+{
+    uint16_t len;
+
+    while (msg_len > 0)
+    {
+        if ((len = can_transport_read(msg, msg_len)) == 0)
+        {
+            return NOK;
+        }
+        msg += len;
+        msg_len -= len;
+    }
+    return OK;
+}
+
+/**
+ * Önce önceki frame den kalan byte lar dönülür. Yoksa bir frame beklenir.
+ * */
+static uint16_t can_transport_read (uint8_t* buf, uint16_t max_len)
+{
+    struct pollfd pfd = { can_fd, POLLIN, 0 };
+    struct can_frame frame;
+    uint16_t len;
+
+    if (pending_index == pending_len)
+    {
+        if (poll(&pfd, 1, CAN_TRANSPORT_RECEIVE_TIMEOUT) <= 0
+                || read(can_fd, &frame, sizeof(frame)) != sizeof(frame))
+        {
+            return 0;
+        }
+        memcpy(pending, frame.data, frame.can_dlc);
+        pending_index = 0;
+        pending_len = frame.can_dlc;
+        rx_cycle = cycle_counter_get( );
+    }
+    len = pending_len - pending_index;
+    if (len > max_len)
+    {
+        len = max_len;
+    }
+    memcpy(buf, &pending[pending_index], len);
+    pending_index += len;
+    return len;
+}
+
+static uint32_t can_transport_get_rx_cycle ( )
+{
+    return rx_cycle;
+}
@@ -0,0 +1,37 @@
+/**
+ * \file        can_transport.h
+ * \brief       Detaylı bilgiyi can_transport.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_TRANSPORT_CAN_TRANSPORT_H_
+#define HOST_TRANSPORT_CAN_TRANSPORT_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "Transport.h"
+/*------------------------------< Defines >-----------------------------------*/
+#define CAN_TRANSPORT_RECEIVE_TIMEOUT (700)     //ms, UART_RECEIVE_TIMEOUT ile aynı
+#define CAN_TRANSPORT_TRANSMIT_TIMEOUT (20)     //ms, TX queue bu süre boşalmazsa çerçevenin kalanı atılır
+#define CAN_TRANSPORT_DEFAULT_RX_ID (0x100)     //hosttan araca
+#define CAN_TRANSPORT_DEFAULT_TX_ID (0x101)     //araçtan hosta
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+extern const transport can_transport;
+/*------------------------------< Prototypes >--------------------------------*/
+void can_transport_configure (const char* ifname, uint32_t rx_id, uint32_t tx_id);
+int can_transport_open_socket (const char* ifname, uint32_t rx_id);
+Return_Status can_transport_send (int fd, uint32_t id, const uint8_t* msg, uint8_t msg_len);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* HOST_TRANSPORT_CAN_TRANSPORT_H_ */
@@ -0,0 +1,139 @@
+/**
+ * \file        pty_transport.c
+ * \brief       Firmware deki haberleşme katmanını bilgisayarda bir pseudo terminal üzerinden çalıştırır.
+ *              init bir pty master açar, host tarafındaki araçlar (replay --capture, comms_bench istemcisi)
+ *              pty_transport_get_slave_name() ile dönen slave e seri port gibi bağlanır.
+ *              Slave ucu init de bir kez açık tutulur. Böylece istemci bağlanmadan veya bağlantıyı
+ *              kapattığında master read i POLLHUP ile sürekli dönmez.
+ *              pty de baud rate kavramı olmadığı için BAUD_REQ reddedilir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#define _GNU_SOURCE
+#include "pty_transport.h"
+#include "helpers.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+static void pty_transport_init ( );
+static void pty_transport_transmit (const uint8_t* msg, uint8_t msg_len);
+static Return_Status pty_transport_receive (uint8_t* msg, uint8_t msg_len);
+static uint16_t pty_transport_read (uint8_t* buf, uint16_t max_len);
+static uint32_t pty_transport_get_rx_cycle ( );
+/*------------------------------< Constants >---------------------------------*/
+const transport pty_transport =
+{
+    .init = pty_transport_init,
+    .transmit = pty_transport_transmit,
+    .receive = pty_transport_receive,
+    .read = pty_transport_read,
+    .get_rx_cycle = pty_transport_get_rx_cycle,
+    .set_baudrate = NULL,
+    .is_baudrate_supported = NULL,
+    .default_baudrate = 0,
+    .get_error_count = NULL,
+};
+/*------------------------------< Variables >---------------------------------*/
+static int master_fd = -1;
+static int slave_fd = -1;     //sadece açık tutulur, okunmaz
+static const char* slave_name;
+static volatile uint32_t rx_cycle;
+/*------------------------------< Functions >---------------------------------*/
+
+const char* pty_transport_get_slave_name ( )
+{
+    return slave_name;
+}
+
+static void pty_transport_init ( )
+{
+    struct termios tio;
+
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0
+            || (slave_name = ptsname(master_fd)) == NULL)
+    {
+        perror("pty");
+        exit(1);
+    }
+    slave_fd = open(slave_name, O_RDWR | O_NOCTTY);
+    if (slave_fd >= 0 && tcgetattr(slave_fd, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(slave_fd, TCSANOW, &tio);
+    }
+}
+
+/**
+ * pty nin buffer ı dolarsa istemci okuyana kadar bekler, UART daki DMA gönderimi gibi veri atılmaz.
+ * */
+static void pty_transport_transmit (const uint8_t* msg, uint8_t msg_len)
+{
+    ssize_t written;
+
+    while (msg_len > 0)
+    {
+        written = write(master_fd, msg, msg_len);
+        if (written < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+            {
+                continue;
+            }
+            return;
+        }
+        msg += written;
+        msg_len -= written;
+    }
+}
+
+static Return_Status pty_transport_receive (uint8_t* msg, uint8_t msg_len)
+{
+    uint16_t len;
+
+    while (msg_len > 0)
+    {
+        if ((len = pty_transport_read(msg, msg_len)) == 0)
+        {
+            return NOK;
+        }
+        msg += len;
+        msg_len -= len;
+    }
+    return OK;
+}
+
+static uint16_t pty_transport_read (uint8_t* buf, uint16_t max_len)
+{
+    struct pollfd pfd = { master_fd, POLLIN, 0 };
+    ssize_t len;
+
+    if (poll(&pfd, 1, PTY_TRANSPORT_RECEIVE_TIMEOUT) <= 0 || (pfd.revents & POLLIN) == 0)
+    {
+        return 0;
+    }
+    len = read(master_fd, buf, max_len);
+    if (len <= 0)
+    {
+        return 0;
+    }
+    rx_cycle = cycle_counter_get( );
+    return (uint16_t) len;
+}
+
+static uint32_t pty_transport_get_rx_cycle ( )
+{
+    return rx_cycle;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file        pty_transport.h
+ * \brief       Detaylı bilgiyi pty_transport.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef HOST_TRANSPORT_PTY_TRANSPORT_H_
+#define HOST_TRANSPORT_PTY_TRANSPORT_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include "Transport.h"
+/*------------------------------< Defines >-----------------------------------*/
+#ifndef PTY_TRANSPORT_RECEIVE_TIMEOUT
+#define PTY_TRANSPORT_RECEIVE_TIMEOUT (700)     //ms, UART_RECEIVE_TIMEOUT ile aynı, -D ile değiştirilebilir
+#endif
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+extern const transport pty_transport;
+/*------------------------------< Prototypes >--------------------------------*/
+const char* pty_transport_get_slave_name ( );
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* HOST_TRANSPORT_PTY_TRANSPORT_H_ */
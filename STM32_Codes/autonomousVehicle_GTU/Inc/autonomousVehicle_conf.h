@@ -31,6 +31,18 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 //Steering pulse values
 #define STEERING_MAX_VALUE (7500)
 #define STEERING_MIN_VALUE (-7500)
+
+//Steering motion profile
+#define STEERING_START_RATE   (4000)     //step/s, motor bu hızda ivmelenmeden kalkar ve durur (eski sabit hız)
+#define STEERING_MAX_RATE     (16000)    //step/s, seyir hızı
+#define STEERING_ACCELERATION (60000)    //step/s^2, hızlanma ve yavaşlama
+#define STEERING_DIR_SETUP_TIME (5)     //us, sürücünün DIR değiştikten sonra ilk step pulse una kadar istediği süre
+
+//UART protocol
+//1: SOF + LEN + PAYLOAD + CRC çerçeveli protokol, 0: eski 3 byte lık çerçevesiz protokol
+#ifndef UART_FRAMED_PROTOCOL
+#define UART_FRAMED_PROTOCOL (1)
+#endif
 /*------------------------------< Typedefs >----------------------------------*/
 enum RETURN_VAL
 {
@@ -9,4 +9,10 @@ void set_green_led (GPIO_PinState PinState);
 void set_orange_led (GPIO_PinState PinState);
 void emergency_stop ( );
 void start_system ( );
+void cycle_counter_init ( );
+uint32_t cycle_counter_get ( );
+uint64_t cycle_counter_extend (uint32_t cycles);
+uint32_t cycle_counter_get_us ( );
+uint32_t cycle_counter_to_us (uint32_t cycles);
+uint32_t tick_get_elapsed_cycles (uint32_t tick);
 #endif
@@ -3,6 +3,9 @@
  * \brief       Communication Mekanizmasında iki thread bulunmaktadır.
  * 				Bunların birtanesi Transmit edilecek veriyi gönderir.
  * 				Diğeri ise Gelen verileri queue koyar.
+ * 				Gelen mesajlar öncelikli START/STOP queue suna, FIFO queue ya veya setpoint mailboxlarına
+ * 				konulur, controller communication_get_msg ile alır. Sonuçlar ACK_REP ile, telemetri ve
+ * 				flight recorder kayıtları transmit threadinden gönderilir.
  *
  * *  Detaylı bilgi için Ahmet Alperen BULUT https://www.linkedin.com/in/ahmetalperenbulut
  * \author      ahmet.alperen.bulut
@@ -12,25 +15,71 @@
 /*------------------------------< Includes >----------------------------------*/
 #include "cmsis_os.h"
 #include "Communication_Mechanism.h"
-#include "UART_Communication.h"
+#include "UART_Frame.h"
+#include "Flight_Recorder.h"
+#include "Telemetry_Codec.h"
 #include "queue.h"
+#include "helpers.h"
+#include <string.h>
 
 /*------------------------------< Defines >-----------------------------------*/
+//QUEUE_LENGTH ve QUEUE_SEND_TIMEOUT bilgisayarda -D ile değiştirilebilir, Host_Codes/linkemu
+#ifndef QUEUE_LENGTH
 #define QUEUE_LENGTH        (10) // 10
-#define REQ_ITEM_SIZE       (sizeof(uart_req)) //3 byte
-#define REP_ITEM_SIZE       (sizeof(uart_rep)) //3byte
+#endif
+#define REQ_ITEM_SIZE       (sizeof(communication_msg)) //12 byte
+#define REP_ITEM_SIZE       (sizeof(uart_rep)) //5 byte
+#ifndef QUEUE_SEND_TIMEOUT
 #define QUEUE_SEND_TIMEOUT  (200)
+#endif
+#define RECEIVE_CHUNK_SIZE  (32)
+#define SAFETY_QUEUE_LENGTH (4)
+#define RX_QUEUE_SEND_TIMEOUT (0)     //receive threadi queue da beklemez, bkz. communication_post_msg
 
 /*------------------------------< Typedefs >----------------------------------*/
+struct COMMUNICATION_ACK_STATE
+{
+    uint8_t seq;
+    uint8_t received;
+    uint16_t results;
+    uint32_t time;     //seq in sonucunun yazıldığı MCU zamanı, us
+    uint8_t pending;     //gönderilmemiş sonuç var
+    uint8_t queued;      //transmit queue da bekleyen bir ACK_REP var
+    TickType_t first_pending_tick;
+};
 
-/*------------------------------< Constants >---------------------------------*/
+enum COMMUNICATION_MAILBOX
+{
+    MAILBOX_BRAKE = 0,
+    MAILBOX_CONTROL = 1,
+    MAILBOX_THROTTLE = 2,
+    MAILBOX_STEER = 3,
+    MAILBOX_COUNT = 4,
+    MAILBOX_NONE = MAILBOX_COUNT
+};
 
+struct COMMUNICATION_MAILBOX_SLOT
+{
+    communication_msg msg;
+    uint32_t order;     //yazıldığı sıra, mailboxlar geliş sırasına göre boşaltılır
+    uint8_t full;
+};
+/*------------------------------< Constants >---------------------------------*/
+_Static_assert(QUEUE_LENGTH < 128, "ACK_REP credits are compared as signed 8 bit sequence distances");
 /*------------------------------< Variables >---------------------------------*/
 static StaticQueue_t xStaticTransmitQueue;
 uint8_t ucTransmitQueueStorageArea[QUEUE_LENGTH * REP_ITEM_SIZE];
 static StaticQueue_t xStaticReceiveQueue;
 uint8_t ucReceiveQueueStorageArea[QUEUE_LENGTH * REQ_ITEM_SIZE];
-QueueHandle_t xQueue_transmit, xQueue_receive;
+static StaticQueue_t xStaticSafetyQueue;
+uint8_t ucSafetyQueueStorageArea[SAFETY_QUEUE_LENGTH * REQ_ITEM_SIZE];
+QueueHandle_t xQueue_transmit, xQueue_receive, xQueue_safety;
+static volatile uint32_t stop_latency_max;     //DWT cycle cinsinden, byte ların gelişinden emergency_stop() un bitişine kadar
+
+static struct COMMUNICATION_MAILBOX_SLOT mailbox[MAILBOX_COUNT];
+static uint32_t mailbox_order;     //mailbox a yazılan son mesajın sırası
+static StaticSemaphore_t xMsgSemaphoreBuffer;
+static SemaphoreHandle_t xMsgSemaphore;     //FIFO ya veya bir mailbox a yeni mesaj konulduğunda controllerı uyandırır.
 
 osThreadId communicationTransmitTaskHandle;
 uint32_t communicationTransmitTaskBuffer[256];
@@ -39,20 +88,80 @@ osStaticThreadDef_t communicationTransmitTaskControlBlock;
 osThreadId communicationReceiveTaskHandle;
 uint32_t communicationReceiveTaskBuffer[256];
 osStaticThreadDef_t communicationReceiveTaskControlBlock;
+
+static struct COMMUNICATION_ACK_STATE ack_state;
+static volatile uint16_t ack_interval = COMMUNICATION_ACK_INTERVAL;
+static communication_telemetry_source telemetry_source;
+static const transport* comm_link;     //mesajların gönderilip alındığı hat
+static volatile TickType_t telemetry_period;     //tick, 0 ise telemetri kapalı
+static volatile uint8_t telemetry_batch;     //0 ise her snapshot TELEMETRY_REP olarak gönderilir
+static volatile uint8_t telemetry_reset;     //ayar değişti, sıradaki snapshot keyframe olacak
+static telemetry_encoder telemetry_codec;     //sadece transmit threadinde kullanılır
+#if UART_FRAMED_PROTOCOL
+static uint8_t tx_seq;
+static volatile uint8_t baud_fallback_pending;     //yeni hızda henüz geçerli bir çerçeve alınmadı
+static volatile TickType_t baud_switch_tick;
+static uart_frame_parser rx_parser;     //CRC ve LEN hata sayaçları DIAG_REQ ile okunur
+static volatile uint16_t rx_size_errors;     //payload boyutu header daki mesajla uyuşmadı
+#endif
+static volatile uint16_t rx_queue_full;     //receive veya safety queue dolu olduğu için atılan mesajlar
+static volatile uint8_t rx_seq;     //queue ya konulan veya atılan en son mesajın sıra numarası, credit bundan sayılır
+static volatile uint16_t rx_timeouts;     //hattan UART_RECEIVE_TIMEOUT boyunca byte gelmedi
+static volatile TickType_t last_rx_tick;     //en son geçerli mesajın geldiği tick, heartbeat olarak kullanılır
 /*------------------------------< Prototypes >--------------------------------*/
 static void communication_receive_task (void const * argument);
+#if UART_FRAMED_PROTOCOL
+static void communication_receive_frame (const uint8_t* payload, uint8_t payload_len, uint8_t seq);
+#endif
 static void communication_transmit_task (void const * argument);
+static void communication_transmit (uart_rep* rep);
+static void communication_transmit_payload (const uint8_t* payload, uint8_t size);
+static void communication_flush_ack ( );
+static void communication_post_ack (uint8_t seq, enum ACK_RESULT result, TickType_t timeout);
+static void communication_switch_baudrate (uint32_t baudrate);
+#if UART_FRAMED_PROTOCOL
+static void communication_check_baud_fallback ( );
+#endif
+static void communication_send_telemetry ( );
+static void communication_send_telemetry_delta (uart_rep* snapshot, uint8_t batch);
+static void communication_flush_telemetry ( );
+static void communication_post_msg (communication_msg* msg);
+static void communication_clear_mailboxes ( );
+static void communication_supersede (uint8_t seq);
+static enum COMMUNICATION_MAILBOX communication_get_mailbox (uint8_t header);
+static uint16_t communication_get_link_error (enum TRANSPORT_ERROR error);
+#if UART_FRAMED_PROTOCOL
+static void communication_reply_sync (const communication_msg* msg);
+#endif
+static void communication_reject_msg (const communication_msg* msg);
+static uint8_t communication_get_credits ( );
 /*------------------------------< Functions >---------------------------------*/
 
-void communication_init ( )
+/**
+ * Hattın init i burada çağrılır, hat başka bir yerde başlatılmamalıdır.
+ * Byte lar verilen transport üzerinden gönderilip alınır, araçta bu uart_transport tur.
+ * */
+void communication_init (const transport* transport_link)
 {
+    comm_link = transport_link;
+    comm_link->init( );
+#if UART_FRAMED_PROTOCOL
+    uart_frame_init( );
+#endif
     xQueue_transmit = xQueueCreateStatic(QUEUE_LENGTH, REP_ITEM_SIZE, ucTransmitQueueStorageArea,
             &xStaticTransmitQueue);
 
     xQueue_receive = xQueueCreateStatic(QUEUE_LENGTH, REQ_ITEM_SIZE, ucReceiveQueueStorageArea,
             &xStaticReceiveQueue);
 
-    osThreadStaticDef(CommunicationReceiveTask, communication_receive_task, osPriorityNormal, 0,
+    xQueue_safety = xQueueCreateStatic(SAFETY_QUEUE_LENGTH, REQ_ITEM_SIZE, ucSafetyQueueStorageArea,
+            &xStaticSafetyQueue);
+
+    xMsgSemaphore = xSemaphoreCreateBinaryStatic(&xMsgSemaphoreBuffer);
+
+    cycle_counter_init( );
+
+    osThreadStaticDef(CommunicationReceiveTask, communication_receive_task, osPriorityHigh, 0,
             256, communicationReceiveTaskBuffer, &communicationReceiveTaskControlBlock);
     communicationReceiveTaskHandle = osThreadCreate(osThread(CommunicationReceiveTask), NULL);
 
@@ -62,57 +171,810 @@ void communication_init ( )
 
 }
 
+#if UART_FRAMED_PROTOCOL
+/**
+ * Gelen byte lar parsera verilir. Parser geçerli bir çerçeve çıkardığında
+ * payload bir request boyutundaysa queue ya konulur. Bir byte birden fazla çerçeveyi tamamlayabilir
+ * (reddedilen bir adaydan sonra), hepsi aynı anda alınır.
+ * */
 void communication_receive_task (void const * argument)
 {
-    uart_req req;
+    uint8_t chunk[RECEIVE_CHUNK_SIZE];
+    uint8_t payload[UART_FRAME_MAX_PAYLOAD_SIZE];
+    uint8_t payload_len;
+    uint8_t seq;
+    uint16_t len;
+    uint16_t i;
+    Return_Status status;
+    uint16_t overflows = communication_get_link_error(TRANSPORT_ERROR_RX_OVERFLOW);
+
     if (xQueue_receive == NULL)
     {
         //error
     }
+    uart_frame_parser_init(&rx_parser);
     while (1)
     {
-        if (uart_receive(req.req.msg, UART_REQ_SIZE) == OK)
+        len = comm_link->read(chunk, RECEIVE_CHUNK_SIZE);
+        if (len == 0)
         {
-            xQueueSend(xQueue_receive, &req, QUEUE_SEND_TIMEOUT);
+            ++rx_timeouts;
+        }
+        if (communication_get_link_error(TRANSPORT_ERROR_RX_OVERFLOW) != overflows)
+        {
+            //Atılan byte lardan önceki yarım çerçeve sonraki byte larla birleştirilmez.
+            overflows = communication_get_link_error(TRANSPORT_ERROR_RX_OVERFLOW);
+            uart_frame_parser_reset(&rx_parser);
+        }
+        for (i = 0; i < len; ++i)
+        {
+            status = uart_frame_parse_byte(&rx_parser, chunk[i], payload, &payload_len, &seq);
+            while (status == OK)
+            {
+                communication_receive_frame(payload, payload_len, seq);
+                status = uart_frame_parse_next(&rx_parser, payload, &payload_len, &seq);
+            }
+        }
+        communication_check_baud_fallback( );
+    }
+}
+
+/**
+ * Mesaja receive threadine ulaştığı tick yazılır. Payloaddan sonra bir byte daha varsa bu mesajın ms
+ * cinsinden geçerlilik süresidir, yoksa COMMUNICATION_DEFAULT_VALIDITY kullanılır.
+ * */
+static void communication_receive_frame (const uint8_t* payload, uint8_t payload_len, uint8_t seq)
+{
+    communication_msg msg;
+
+    baud_fallback_pending = 0;
+    memcpy(&msg.req, payload, (payload_len < sizeof(uart_req)) ? payload_len : sizeof(uart_req));
+    if (payload_len == get_req_msg_size(&msg.req))
+    {
+        msg.validity = COMMUNICATION_DEFAULT_VALIDITY;
+    }
+    else if (payload_len == get_req_msg_size(&msg.req) + 1)
+    {
+        msg.validity = payload[payload_len - 1];
+    }
+    else
+    {
+        ++rx_size_errors;
+        return;
+    }
+    msg.seq = seq;
+    msg.arrival_tick = xTaskGetTickCount( );
+    communication_post_msg(&msg);
+}
+#else
+void communication_receive_task (void const * argument)
+{
+    communication_msg msg = { 0 };
+    if (xQueue_receive == NULL)
+    {
+        //error
+    }
+    while (1)
+    {
+        if (comm_link->receive(msg.req.req.msg, UART_REQ_SIZE) == OK)
+        {
+            msg.validity = COMMUNICATION_DEFAULT_VALIDITY;
+            msg.arrival_tick = xTaskGetTickCount( );
+            communication_post_msg(&msg);
         }
         else
         {
-            //TODO error
+            ++rx_timeouts;
         }
         //osDelay(1);
     }
 }
+#endif
 
+/**
+ * Queue daki ACK_REP sadece bir işarettir. İşaret alındığında ack gönderilmesi gerektiği anlaşılır,
+ * gönderilen değerler ise o anki ack_state den alınır. Böylece işaret queue da beklerken gelen
+ * sonuçlar da aynı ACK_REP e eklenir.
+ * Telemetri açıksa her periyotta bir snapshot gönderilir. Flight recorder dump ı sürerken transmit queue
+ * boş kaldıkça sıradaki kayıt gönderilir.
+ * */
 void communication_transmit_task (void const * argument)
 {
     uart_rep rep;
+    uint8_t ack_due = 0;
+    TickType_t wait;
+    TickType_t telemetry_tick = xTaskGetTickCount( );
     if (xQueue_transmit == NULL)
     {
         //TODO error
     }
     while (1)
     {
-        if (xQueueReceive(xQueue_transmit, &(rep), (TickType_t) portMAX_DELAY) == pdTRUE)
+        TickType_t period = telemetry_period;
+
+        if (!ack_due && ack_state.pending && !ack_state.queued)
+        {
+            ack_due = 1;     //receive threadi queue dolu olduğu için işaret koyamadı
+        }
+        wait = portMAX_DELAY;
+        if (ack_due)
+        {
+            TickType_t elapsed = xTaskGetTickCount( ) - ack_state.first_pending_tick;
+            wait = (elapsed >= ack_interval) ? 0 : ack_interval - elapsed;
+        }
+        if (flight_recorder_is_dumping( ))
+        {
+            wait = 0;
+        }
+        if (period != 0)
+        {
+            TickType_t elapsed = xTaskGetTickCount( ) - telemetry_tick;
+            TickType_t telemetry_wait = (elapsed >= period) ? 0 : period - elapsed;
+            if (telemetry_wait < wait)
+            {
+                wait = telemetry_wait;
+            }
+        }
+        if (xQueueReceive(xQueue_transmit, &(rep), wait) != pdTRUE)
         {
-            uart_transmit(rep.rep.msg, UART_REP_SIZE);
+            if (flight_recorder_dump_next(&rep) == OK)
+            {
+                communication_transmit(&rep);
+            }
+        }
+        else
+        {
+            if (rep.rep_packed.header == ACK_REP)
+            {
+                ack_due = 1;
+            }
+            else
+            {
+                communication_transmit(&rep);
+                if (rep.rep_packed.header == BAUD_REP && rep.rep_packed.data != 0)
+                {
+                    communication_switch_baudrate((uint32_t) rep.rep_packed.data * UART_BAUD_UNIT);
+                }
+            }
+        }
+        if (ack_due
+                && (uxQueueMessagesWaiting(xQueue_transmit) == 0
+                        || xTaskGetTickCount( ) - ack_state.first_pending_tick >= ack_interval))
+        {
+            communication_flush_ack( );
+            ack_due = 0;
+        }
+        if (period != 0 && xTaskGetTickCount( ) - telemetry_tick >= period)
+        {
+            //Hat yetişemeyip geride kalındıysa kaçırılan snapshotlar arka arkaya gönderilmez.
+            telemetry_tick += period;
+            if (xTaskGetTickCount( ) - telemetry_tick >= period)
+            {
+                telemetry_tick = xTaskGetTickCount( );
+            }
+            communication_send_telemetry( );
         }
        // osDelay(1);
     }
 }
 
-Return_Status communication_get_msg (uart_req* msg)
+/**
+ * SYNC_REP in gönderme zamanı çerçeve transport a yazılırken alınır.
+ * */
+static void communication_transmit (uart_rep* rep)
 {
-    if (xQueueReceive(xQueue_receive, msg, (TickType_t) portMAX_DELAY) == pdTRUE)
+#if UART_FRAMED_PROTOCOL
+    if (rep->rep_packed.header == SYNC_REP)
     {
+        uart_set_SYNC_REP_tx_time(rep, cycle_counter_get_us( ));
+    }
+    communication_transmit_payload(rep->rep.msg, get_rep_msg_size(rep));
+#else
+    communication_transmit_payload(rep->rep.msg, UART_REP_SIZE);
+#endif
+}
+
+/**
+ * Boyutu mesaj tablosundan bulunamayan (TELEMETRY_DELTA_REP) payloadlar da buradan gönderilir.
+ * */
+static void communication_transmit_payload (const uint8_t* payload, uint8_t size)
+{
+#if UART_FRAMED_PROTOCOL
+    uint8_t frame[UART_FRAME_MAX_SIZE];
+    comm_link->transmit(frame, uart_frame_encode(payload, size, tx_seq++, frame));
+#else
+    comm_link->transmit(payload, size);
+#endif
+}
+
+static void communication_flush_ack ( )
+{
+    uart_rep rep;
+
+    taskENTER_CRITICAL();
+    create_ack_rep_msg(&rep, ack_state.seq, ack_state.received, ack_state.results, ack_state.time,
+            communication_get_queue_length( ), rx_seq, communication_get_credits( ));
+    ack_state.pending = 0;
+    ack_state.queued = 0;
+    taskEXIT_CRITICAL();
+    communication_transmit(&rep);
+}
+
+/**
+ * Controller threadinden çağrılır, transmit queue doluysa işaret için QUEUE_SEND_TIMEOUT kadar bekler.
+ * */
+void communication_ack (uint8_t seq, enum ACK_RESULT result)
+{
+    communication_post_ack(seq, result, QUEUE_SEND_TIMEOUT);
+}
+
+/**
+ * Her request için ayrı GENERIC_REP gönderilmez. Sonuçlar biriktirilir ve son UART_ACK_WINDOW request i
+ * kapsayan tek bir ACK_REP transmit queue boşaldığında veya ack aralığı dolduğunda gönderilir.
+ * Requestin sonucunu ack penceresine yazar. Bekleyen bir ACK_REP yoksa transmit queue ya işaret koyar.
+ * Receive threadi timeout olarak RX_QUEUE_SEND_TIMEOUT verir ve beklemez. İşaret konulamazsa sonuç
+ * pencerede kalır, transmit threadi queue yu boşaltırken bunu görür ve ACK_REP i yine gönderir.
+ * seq penceredeki en yeni numaradan büyükse pencere kaydırılır, pencere içinde eski bir numaraysa
+ * sadece o numaranın biti güncellenir. Pencereden daha eski bir numaranın sonucu atılır, geç gelen
+ * eski bir sonuç pencereyi geri almamalıdır.
+ * */
+static void communication_post_ack (uint8_t seq, enum ACK_RESULT result, TickType_t timeout)
+{
+    uart_rep rep;
+    uint8_t queue = 0;
+    int8_t delta;
+    uint32_t time = cycle_counter_get_us( );
+
+    taskENTER_CRITICAL();
+    delta = (int8_t) (seq - ack_state.seq);
+    if (delta <= -UART_ACK_WINDOW)
+    {
+        taskEXIT_CRITICAL();
+        return;
+    }
+    if (delta >= UART_ACK_WINDOW)
+    {
+        ack_state.seq = seq;
+        ack_state.received = 0;
+        ack_state.results = 0;
+        delta = 0;
+    }
+    else if (delta > 0)
+    {
+        ack_state.seq = seq;
+        ack_state.received <<= delta;
+        ack_state.results <<= 2 * delta;
+        delta = 0;
+    }
+    if (delta == 0)
+    {
+        ack_state.time = time;
+    }
+    delta = -delta;
+    ack_state.received |= (1 << delta);
+    ack_state.results &= ~(0x3 << (2 * delta));
+    ack_state.results |= (result & 0x3) << (2 * delta);
+    if (ack_state.pending == 0)
+    {
+        ack_state.pending = 1;
+        ack_state.first_pending_tick = xTaskGetTickCount( );
+    }
+    if (ack_state.queued == 0)
+    {
+        ack_state.queued = 1;
+        queue = 1;
+    }
+    taskEXIT_CRITICAL();
+
+    if (queue)
+    {
+        rep.rep_packed.header = ACK_REP;
+        if (xQueueSend(xQueue_transmit, &rep, timeout) != pdTRUE)
+        {
+            taskENTER_CRITICAL();
+            ack_state.queued = 0;
+            taskEXIT_CRITICAL();
+        }
+    }
+}
+
+void communication_set_ack_interval (uint16_t interval)
+{
+    ack_interval = interval;
+}
+
+/**
+ * Host un önerdiği hız destekleniyorsa BAUD_REP ile kabul edilir, değilse 0 ile reddedilir.
+ * Hız, BAUD_REP eski hızda gönderildikten sonra transmit threadinde değiştirilir.
+ * */
+Return_Status communication_request_baudrate (uint32_t baudrate)
+{
+    uart_rep rep;
+    Return_Status ret_val = OK;
+
+    if (comm_link->is_baudrate_supported == NULL || !comm_link->is_baudrate_supported(baudrate))
+    {
+        baudrate = 0;
+        ret_val = NOK;
+    }
+    create_baud_rep_msg(&rep, baudrate);
+    if (communication_send_msg(&rep) != OK)
+    {
+        return NOK;
+    }
+    return ret_val;
+}
+
+/**
+ * Çerçevesiz protokolde yeni hızda gelen byte ların geçerli olup olmadığı anlaşılamaz,
+ * bu yüzden eski hıza geri dönüş sadece çerçeveli protokolde yapılır.
+ * */
+static void communication_switch_baudrate (uint32_t baudrate)
+{
+#if UART_FRAMED_PROTOCOL
+    if (comm_link->set_baudrate(baudrate) == OK && baudrate != comm_link->default_baudrate)
+    {
+        baud_switch_tick = xTaskGetTickCount( );
+        baud_fallback_pending = 1;
+    }
+#else
+    comm_link->set_baudrate(baudrate);
+#endif
+}
+
+#if UART_FRAMED_PROTOCOL
+/**
+ * Host yeni hıza geçemediyse hat bir daha hiç çözülemez. Receive threadi hattın read inden
+ * en fazla UART_RECEIVE_TIMEOUT sonra döndüğü için geri dönüş bu kadar gecikebilir.
+ * */
+static void communication_check_baud_fallback ( )
+{
+    if (baud_fallback_pending
+            && xTaskGetTickCount( ) - baud_switch_tick >= pdMS_TO_TICKS(COMMUNICATION_BAUD_FALLBACK_TIMEOUT))
+    {
+        baud_fallback_pending = 0;
+        comm_link->set_baudrate(comm_link->default_baudrate);
+    }
+}
+#endif
+
+void communication_set_telemetry_source (communication_telemetry_source source)
+{
+    telemetry_source = source;
+}
+
+/**
+ * rate Hz cinsindendir, 0 telemetriyi kapatır. COMMUNICATION_TELEMETRY_RATE_MIN ve
+ * COMMUNICATION_TELEMETRY_RATE_MAX dışındaki değerler reddedilir.
+ * Periyot en yakın tick e yuvarlanır, kesirli kısmı atılsaydı 400 Hz 500 Hz olurdu.
+ * 0 tick e yuvarlanan hız reddedilir, 0 telemetri kapalı demektir.
+ * */
+Return_Status communication_set_telemetry_rate (uint16_t rate)
+{
+    TickType_t period;
+
+    if (rate == 0)
+    {
+        telemetry_period = 0;
         return OK;
     }
+    period = (configTICK_RATE_HZ + rate / 2) / rate;
+    if (rate < COMMUNICATION_TELEMETRY_RATE_MIN || rate > COMMUNICATION_TELEMETRY_RATE_MAX || period == 0)
+    {
+        return NOK;
+    }
+    telemetry_period = period;
+    telemetry_reset = 1;
+    return OK;
+}
 
-    return NOK;
+/**
+ * batch 0 ise snapshotlar sıkıştırılmadan gönderilir. Değilse batch kadar snapshot birikince veya çerçeve
+ * dolunca bir TELEMETRY_DELTA_REP gönderilir. Büyük batch hattı daha az kullanır ama her snapshot en fazla
+ * batch - 1 periyot gecikir. COMMUNICATION_TELEMETRY_BATCH_MAX tan büyük değerler reddedilir.
+ * */
+Return_Status communication_set_telemetry_batch (uint16_t batch)
+{
+    if (batch > COMMUNICATION_TELEMETRY_BATCH_MAX)
+    {
+        return NOK;
+    }
+    telemetry_batch = batch;
+    telemetry_reset = 1;
+    return OK;
+}
+
+/**
+ * Aktüatör ve sensör alanlarını controllerın kaydettiği kaynak doldurur, tick, zaman ve queue
+ * doluluklarını bu modül ekler.
+ * */
+static void communication_send_telemetry ( )
+{
+    uart_rep rep = { 0 };
+
+    if (telemetry_source != NULL)
+    {
+        telemetry_source(&rep);
+    }
+    uart_set_TELEMETRY_REP_tick(&rep, xTaskGetTickCount( ));
+    uart_set_TELEMETRY_REP_time(&rep, cycle_counter_get_us( ));
+    uart_set_TELEMETRY_REP_rx_queue(&rep, communication_get_queue_length( ));
+    uart_set_TELEMETRY_REP_tx_queue(&rep, uxQueueMessagesWaiting(xQueue_transmit));
+    if (telemetry_reset)
+    {
+        //Bekleyen delta çerçevesi eski ayara aittir ve atılır. Bir index boşluğu oluşmaz, keyframe index i sıfırlar.
+        telemetry_reset = 0;
+        telemetry_encoder_init(&telemetry_codec);
+    }
+    if (telemetry_batch != 0)
+    {
+        communication_send_telemetry_delta(&rep, telemetry_batch);
+    }
+    else
+    {
+        communication_transmit(&rep);
+    }
+}
+
+/**
+ * Snapshotlar Telemetry_Codec ile delta olarak kodlanır, batch kadar snapshot bir TELEMETRY_DELTA_REP te
+ * gönderilir. Belirli aralıklarla ve ayar değiştiğinde tam TELEMETRY_REP keyframe olarak gönderilir.
+ * Keyframe zamanı geldiyse bekleyen delta çerçevesi önce gönderilir, böylece host örnekleri sırayla alır.
+ * */
+static void communication_send_telemetry_delta (uart_rep* snapshot, uint8_t batch)
+{
+    if (telemetry_encoder_is_keyframe_due(&telemetry_codec))
+    {
+        communication_flush_telemetry( );
+        telemetry_encoder_keyframe(&telemetry_codec, snapshot);
+        communication_transmit(snapshot);
+        return;
+    }
+    if (telemetry_encoder_add(&telemetry_codec, snapshot) != OK)
+    {
+        communication_flush_telemetry( );
+        telemetry_encoder_add(&telemetry_codec, snapshot);
+    }
+    if (telemetry_codec.count >= batch)
+    {
+        communication_flush_telemetry( );
+    }
+}
+
+static void communication_flush_telemetry ( )
+{
+    uint8_t payload[TELEMETRY_CODEC_MAX_SIZE];
+    uint8_t size = telemetry_encoder_flush(&telemetry_codec, payload);
+
+    if (size != 0)
+    {
+        communication_transmit_payload(payload, size);
+    }
+}
+
+/**
+ * Hat kalitesi sayaçlarını döner. Bu modülün tutmadığı sayaçlar için 0 döner.
+ * Sayaçlar 16 bittir ve 0xFFFF ten sonra başa döner, host iki okuma arasındaki farka bakmalıdır.
+ * */
+uint16_t communication_get_diag (uint16_t counter)
+{
+    switch (counter)
+    {
+        case DIAG_UART_OVERRUN:
+            return communication_get_link_error(TRANSPORT_ERROR_OVERRUN);
+        case DIAG_UART_FRAMING:
+            return communication_get_link_error(TRANSPORT_ERROR_FRAMING);
+        case DIAG_UART_NOISE:
+            return communication_get_link_error(TRANSPORT_ERROR_NOISE);
+        case DIAG_UART_PARITY:
+            return communication_get_link_error(TRANSPORT_ERROR_PARITY);
+        case DIAG_RX_OVERFLOW:
+            return communication_get_link_error(TRANSPORT_ERROR_RX_OVERFLOW);
+#if UART_FRAMED_PROTOCOL
+        case DIAG_CRC_ERRORS:
+            return rx_parser.crc_errors;
+        case DIAG_HEADER_ERRORS:
+            return rx_parser.length_errors + rx_size_errors;
+#endif
+        case DIAG_QUEUE_FULL:
+            return rx_queue_full;
+        case DIAG_RX_TIMEOUTS:
+            return rx_timeouts;
+        case DIAG_STOP_LATENCY_MAX:
+        {
+            uint32_t latency = stop_latency_max / (SystemCoreClock / 1000000);
+            return (latency > 0xFFFF) ? 0xFFFF : latency;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Hosttan en son geçerli mesajın geldiği tick. Mesaj başına tek bir yazma yapılır,
+ * heartbeat supervisor bu değere bakar.
+ * */
+TickType_t communication_get_last_rx_tick ( )
+{
+    return last_rx_tick;
+}
+
+static uint16_t communication_get_link_error (enum TRANSPORT_ERROR error)
+{
+    if (comm_link->get_error_count == NULL)
+    {
+        return 0;
+    }
+    return comm_link->get_error_count(error);
+}
+
+/**
+ * Setpoint mesajları ilgili tek elemanlık mailbox a yazılır, üzerine yazılan eski setpoint uygulanmamış
+ * olarak cevaplanır. START_STOP_REQ öncelikli queue ya, diğer mesajlar FIFO queue ya konulur.
+ * STOP controller beklenmeden burada uygulanır. Receive threadi en yüksek uygulama önceliğinde çalıştığı
+ * için durma gecikmesi hattın veya queue ların doluluğuna bağlı değildir. Controller aktüatörleri
+ * is_started ile aynı kritik bölgede yazdığı için STOP un controllerdaki kopyası bir şey düzeltmez,
+ * öncelikli queue dolu olsa da STOP geçerlidir ve OK ile cevaplanır.
+ * STOP ayrıca mailboxlarda bekleyen setpointleri atar, bkz. communication_clear_mailboxes.
+ * Queue doluysa beklenmez, mesaj reddedilir. Beklerken UART ta biriken byte lar kaybolabilirdi.
+ * rx_seq mesaj queue ya konulduktan sonra yazılır. Arada gönderilen bir ACK_REP eski rx_seq i yeni
+ * doluluğla bildirir, credit hiçbir zaman fazla sayılmaz.
+ * */
+static void communication_post_msg (communication_msg* msg)
+{
+    enum COMMUNICATION_MAILBOX box = communication_get_mailbox(msg->req.req_packed.header);
+    int16_t superseded_seq = -1;     //mailbox ta üzerine yazılan mesajın sıra numarası
+
+    last_rx_tick = msg->arrival_tick;
+#if UART_FRAMED_PROTOCOL
+    if (msg->req.req_packed.header == SYNC_REQ)
+    {
+        communication_reply_sync(msg);
+    }
+#endif
+    if (msg->req.req_packed.header == START_STOP_REQ)
+    {
+        if (msg->req.req_packed.data == 0)
+        {
+            uint32_t latency;
+
+            msg->validity = 0;     //STOP hiçbir zaman geçersiz sayılmaz
+
+            emergency_stop( );
+            latency = cycle_counter_get( ) - comm_link->get_rx_cycle( );
+            if (latency > stop_latency_max)
+            {
+                stop_latency_max = latency;
+            }
+            communication_clear_mailboxes( );
+        }
+        if (xQueueSend(xQueue_safety, msg, RX_QUEUE_SEND_TIMEOUT) != pdTRUE)
+        {
+            if (msg->req.req_packed.data == 0)
+            {
+                //STOP yukarıda uygulandı, queue daki kopya sadece ACK ve kayıt içindir
+                ++rx_queue_full;
+                rx_seq = msg->seq;
+#if UART_FRAMED_PROTOCOL
+                communication_post_ack(msg->seq, ACK_OK, RX_QUEUE_SEND_TIMEOUT);
+#endif
+                return;
+            }
+            communication_reject_msg(msg);
+            return;
+        }
+    }
+    else if (box == MAILBOX_NONE)
+    {
+        if (xQueueSend(xQueue_receive, msg, RX_QUEUE_SEND_TIMEOUT) != pdTRUE)
+        {
+            communication_reject_msg(msg);
+            return;
+        }
+    }
+    else
+    {
+        taskENTER_CRITICAL();
+        if (mailbox[box].full)
+        {
+            superseded_seq = mailbox[box].msg.seq;
+        }
+        mailbox[box].msg = *msg;
+        mailbox[box].order = ++mailbox_order;
+        mailbox[box].full = 1;
+        taskEXIT_CRITICAL();
+
+        if (superseded_seq >= 0)
+        {
+            communication_supersede((uint8_t) superseded_seq);
+        }
+    }
+    rx_seq = msg->seq;
+    xSemaphoreGive(xMsgSemaphore);
+}
+
+/**
+ * STOP tan önce gelip henüz uygulanmamış setpointler atılır ve uygulanmamış olarak cevaplanır. Atılmasalardı
+ * controller öncelikli queue yu önce boşalttığı için STOP ve ardından gelen START tan sonra uygulanırlardı.
+ * */
+static void communication_clear_mailboxes ( )
+{
+    int16_t superseded_seq[MAILBOX_COUNT];
+    uint8_t box;
+
+    taskENTER_CRITICAL();
+    for (box = 0; box < MAILBOX_COUNT; ++box)
+    {
+        superseded_seq[box] = mailbox[box].full ? mailbox[box].msg.seq : -1;
+        mailbox[box].full = 0;
+    }
+    taskEXIT_CRITICAL();
+
+    for (box = 0; box < MAILBOX_COUNT; ++box)
+    {
+        if (superseded_seq[box] >= 0)
+        {
+            communication_supersede((uint8_t) superseded_seq[box]);
+        }
+    }
+}
+
+/**
+ * Uygulanmadan atılan bir setpointi cevaplar. Receive threadinden çağrılır, beklemez.
+ * */
+static void communication_supersede (uint8_t seq)
+{
+#if UART_FRAMED_PROTOCOL
+    communication_post_ack(seq, ACK_SUPERSEDED, RX_QUEUE_SEND_TIMEOUT);
+#else
+    uart_rep rep;
+    create_general_rep_msg(&rep, 0);
+    if (xQueueSend(xQueue_transmit, &rep, RX_QUEUE_SEND_TIMEOUT) != pdTRUE)
+    {
+        ++rx_queue_full;
+    }
+#endif
+}
+
+/**
+ * Queue ya sığmayan mesaj controllera ulaşmadan Error ile cevaplanır. Host komutu timeout beklemeden
+ * tekrar gönderebilir.
+ * */
+static void communication_reject_msg (const communication_msg* msg)
+{
+    ++rx_queue_full;
+    rx_seq = msg->seq;
+#if UART_FRAMED_PROTOCOL
+    communication_post_ack(msg->seq, ACK_ERROR, RX_QUEUE_SEND_TIMEOUT);
+#endif
+}
+
+/**
+ * FIFO queue daki boş yer sayısı, her ACK_REP te en son alınan sıra numarasıyla birlikte gönderilir.
+ * Host credit modunda bu sınırın ötesine request göndermez. Mailbox a giden setpointler yer tutmaz, host
+ * yine de her request i bir credit sayar. START/STOP kendi queue sunda beklediği için sayılmaz.
+ * */
+static uint8_t communication_get_credits ( )
+{
+    return QUEUE_LENGTH - uxQueueMessagesWaiting(xQueue_receive);
+}
+
+#if UART_FRAMED_PROTOCOL
+/**
+ * Controller ve FIFO beklenmeden SYNC_REP transmit queue ya konulur. Mesaj yine de FIFO ya konulur,
+ * ACK i controllerdan gelir. Geliş zamanı receive kesmesinin DWT değerinden alınır. Telemetri ve ACK_REP
+ * de aynı us saatiyle zaman damgalanır, host bunları SYNC ölçümleriyle kendi saatine çevirir.
+ * */
+static void communication_reply_sync (const communication_msg* msg)
+{
+    uart_rep rep = { 0 };
+    uint32_t host_time;
+
+    parse_sync_msg(&msg->req, &host_time);
+    create_sync_rep_msg(&rep, host_time, cycle_counter_to_us(comm_link->get_rx_cycle( )));
+    if (xQueueSend(xQueue_transmit, &rep, 0) != pdTRUE)
+    {
+        ++rx_queue_full;
+    }
+}
+#endif
+
+static enum COMMUNICATION_MAILBOX communication_get_mailbox (uint8_t header)
+{
+    switch (header)
+    {
+        case STEERING_REQ:
+            return MAILBOX_STEER;
+        case THROTTLE_REQ:
+            return MAILBOX_THROTTLE;
+        case BRAKE_REQ:
+            return MAILBOX_BRAKE;
+        case CONTROL_REQ:
+            return MAILBOX_CONTROL;
+        default:
+            return MAILBOX_NONE;
+    }
+}
+
+/**
+ * Önce öncelikli queue daki START/STOP, sonra FIFO daki olaylar,
+ * en son mailboxlardaki en güncel setpointler döndürülür.
+ * Mailboxlar geliş sırasına göre boşaltılır. CONTROL_REQ fren, gaz ve direksiyonu birlikte yazdığı için
+ * sabit bir sırayla alınsaydı eski bir CONTROL_REQ kendisinden sonra gelen BRAKE_REQ in üzerine yazabilirdi.
+ * Hiç mesaj yoksa yeni bir mesaj gelene kadar bekler.
+ * */
+Return_Status communication_get_msg (communication_msg* msg)
+{
+    uint8_t box;
+    uint8_t oldest;
+
+    while (1)
+    {
+        if (xQueueReceive(xQueue_safety, msg, 0) == pdTRUE)
+        {
+            return OK;
+        }
+        if (xQueueReceive(xQueue_receive, msg, 0) == pdTRUE)
+        {
+            return OK;
+        }
+        oldest = MAILBOX_NONE;
+        taskENTER_CRITICAL();
+        for (box = 0; box < MAILBOX_COUNT; ++box)
+        {
+            if (mailbox[box].full
+                    && (oldest == MAILBOX_NONE || (int32_t) (mailbox[box].order - mailbox[oldest].order) < 0))
+            {
+                oldest = box;
+            }
+        }
+        if (oldest != MAILBOX_NONE)
+        {
+            *msg = mailbox[oldest].msg;
+            mailbox[oldest].full = 0;
+        }
+        taskEXIT_CRITICAL();
+        if (oldest != MAILBOX_NONE)
+        {
+            return OK;
+        }
+        if (xSemaphoreTake(xMsgSemaphore, (TickType_t) portMAX_DELAY) != pdTRUE)
+        {
+            return NOK;
+        }
+    }
+}
+
+/**
+ * Mesajın geçerlilik süresi dolduysa 1 döner.
+ * */
+uint8_t communication_is_expired (const communication_msg* msg)
+{
+    if (msg->validity == 0)
+    {
+        return 0;
+    }
+    return (xTaskGetTickCount( ) - msg->arrival_tick) > pdMS_TO_TICKS(msg->validity);
+}
+
+/**
+ * Şimdiye kadar ölçülen en kötü STOP gecikmesini DWT cycle cinsinden döner.
+ * */
+uint32_t communication_get_stop_latency_max ( )
+{
+    return stop_latency_max;
 }
 
 uint8_t communication_get_queue_length ( )
 {
-    return uxQueueMessagesWaiting(xQueue_receive);
+    uint8_t len = uxQueueMessagesWaiting(xQueue_receive) + uxQueueMessagesWaiting(xQueue_safety);
+    uint8_t box;
+
+    for (box = 0; box < MAILBOX_COUNT; ++box)
+    {
+        len += mailbox[box].full;
+    }
+    return len;
 }
 
 Return_Status communication_send_msg (uart_rep* msg)
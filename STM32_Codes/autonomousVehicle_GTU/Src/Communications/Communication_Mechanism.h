@@ -15,19 +15,46 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 
 /*------------------------------< Includes >----------------------------------*/
 #include "UART_Message.h"
+#include "Transport.h"
 #include "autonomousVehicle_conf.h"
+#include "cmsis_os.h"
 /*------------------------------< Defines >-----------------------------------*/
-
+#define COMMUNICATION_ACK_INTERVAL (10)     //ms, ACK_REP en fazla bu sürede bir gönderilir
+#define COMMUNICATION_DEFAULT_VALIDITY (200)     //ms, çerçevede geçerlilik süresi yoksa kullanılır
+#define COMMUNICATION_TELEMETRY_RATE_MIN (10)     //Hz
+#define COMMUNICATION_TELEMETRY_RATE_MAX (500)    //Hz, tick 1 kHz olduğu için periyot en az 2 tick
+#define COMMUNICATION_TELEMETRY_BATCH_MAX (16)    //delta çerçevesinde biriktirilen en fazla snapshot
+#define COMMUNICATION_BAUD_FALLBACK_TIMEOUT (1000)     //ms, hız değiştikten sonra bu sürede geçerli çerçeve gelmezse transportun default_baudrate ine dönülür
 /*------------------------------< Typedefs >----------------------------------*/
+struct COMMUNICATION_MSG
+{
+    uart_req req;
+    uint8_t seq;     //çerçevenin sıra numarası, çerçevesiz protokolde 0
+    uint8_t validity;     //ms, 0 ise süresi dolmaz
+    TickType_t arrival_tick;     //çerçevenin receive threadine ulaştığı tick
+};
+
+typedef struct COMMUNICATION_MSG communication_msg;
+typedef void (*communication_telemetry_source) (uart_rep* rep);     //snapshotın aktüatör ve sensör alanlarını doldurur
 
 /*------------------------------< Constants >---------------------------------*/
 
 /*------------------------------< Prototypes >--------------------------------*/
 
-void communication_init ( );
-Return_Status communication_get_msg (uart_req* msg);
+void communication_init (const transport* transport_link);
+Return_Status communication_get_msg (communication_msg* msg);
 uint8_t communication_get_queue_length ( );
 Return_Status communication_send_msg (uart_rep* msg);
+void communication_ack (uint8_t seq, enum ACK_RESULT result);
+void communication_set_ack_interval (uint16_t interval);
+uint32_t communication_get_stop_latency_max ( );
+uint8_t communication_is_expired (const communication_msg* msg);
+Return_Status communication_request_baudrate (uint32_t baudrate);
+void communication_set_telemetry_source (communication_telemetry_source source);
+Return_Status communication_set_telemetry_rate (uint16_t rate);
+Return_Status communication_set_telemetry_batch (uint16_t batch);
+uint16_t communication_get_diag (uint16_t counter);
+TickType_t communication_get_last_rx_tick ( );
 
 #if defined(__cplusplus)
 }                /* Make sure we have C-declarations in C++ programs */
@@ -0,0 +1,125 @@
+/**
+ * \file        Flight_Recorder.c
+ * \brief       Controllerın işlediği her request, geliş tick i, işlenme süresi ve sonucu ile birlikte
+ *              CCMRAM deki bir ring buffera yazılır. Buffer dolduğunda en eski kayıtların üzerine yazılır.
+ *              CCMRAM section ı NOLOAD olduğu için kayıtlar resetten sonra da korunur, magic doğruysa
+ *              buffer temizlenmez. Böylece sahada olan bir olaydan sonra araç resetlense de kayıt okunabilir.
+ *              RECORDER_DUMP_REQ geldiğinde kayıt durdurulur ve transmit threadi transmit queue boşaldıkça
+ *              kayıtları en eskiden en yeniye RECORDER_REP olarak gönderir. Dump bitince kayıt devam eder.
+ *              Kayıtlar Host_Codes/replay ile bilgisayarda tekrar oynatılabilir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "Flight_Recorder.h"
+#include "cmsis_os.h"
+#include <string.h>
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+struct FLIGHT_RECORDER
+{
+    uint32_t magic;
+    uint16_t head;      //bir sonraki kaydın yazılacağı index
+    uint16_t count;     //buffer daki kayıt sayısı
+    flight_recorder_entry entries[FLIGHT_RECORDER_LENGTH];
+};
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+static struct FLIGHT_RECORDER recorder __attribute__((section(".ccmram")));
+
+static volatile uint8_t dumping;
+static uint16_t dump_index;         //gönderilecek bir sonraki kaydın indexi
+static uint16_t dump_remaining;     //gönderilecek kayıt sayısı
+/*------------------------------< Prototypes >--------------------------------*/
+
+/*------------------------------< Functions >---------------------------------*/
+
+void flight_recorder_init ( )
+{
+    if (recorder.magic != FLIGHT_RECORDER_MAGIC || recorder.head >= FLIGHT_RECORDER_LENGTH
+            || recorder.count > FLIGHT_RECORDER_LENGTH)
+    {
+        recorder.head = 0;
+        recorder.count = 0;
+        recorder.magic = FLIGHT_RECORDER_MAGIC;
+    }
+}
+
+/**
+ * Dump sürerken gelen kayıtlar atılır.
+ * */
+void flight_recorder_record (const communication_msg* msg, enum ACK_RESULT result, uint32_t cycles)
+{
+    flight_recorder_entry* entry;
+
+    if (dumping)
+    {
+        return;
+    }
+    entry = &recorder.entries[recorder.head];
+    entry->tick = msg->arrival_tick;
+    entry->cycles = cycles;
+    entry->req = msg->req;
+    entry->seq = msg->seq;
+    entry->validity = msg->validity;
+    entry->result = result;
+
+    taskENTER_CRITICAL();
+    recorder.head = (recorder.head + 1) % FLIGHT_RECORDER_LENGTH;
+    if (recorder.count < FLIGHT_RECORDER_LENGTH)
+    {
+        ++recorder.count;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * Kaydı durdurur ve dump ı başlatır. Gönderilecek kayıt sayısını döner.
+ * */
+uint16_t flight_recorder_start_dump ( )
+{
+    taskENTER_CRITICAL();
+    dump_index = (recorder.head + FLIGHT_RECORDER_LENGTH - recorder.count) % FLIGHT_RECORDER_LENGTH;
+    dump_remaining = recorder.count;
+    dumping = 1;
+    taskEXIT_CRITICAL();
+    return dump_remaining;
+}
+
+uint8_t flight_recorder_is_dumping ( )
+{
+    return dumping;
+}
+
+/**
+ * Sıradaki kaydı RECORDER_REP olarak rep e yazar. REP deki remaining bu kayıttan sonra kalan kayıt sayısıdır,
+ * 0 olduğunda dump biter ve kayıt tekrar başlar. Buffer boşsa tek bir boş kayıt gönderilir.
+ * Dump yoksa NOK döner.
+ * */
+Return_Status flight_recorder_dump_next (uart_rep* rep)
+{
+    if (!dumping)
+    {
+        return NOK;
+    }
+    if (dump_remaining == 0)
+    {
+        memset(rep->recorder_packed.entry, FLIGHT_RECORDER_NO_ENTRY, UART_RECORDER_ENTRY_SIZE);
+    }
+    else
+    {
+        memcpy(rep->recorder_packed.entry, &recorder.entries[dump_index], UART_RECORDER_ENTRY_SIZE);
+        dump_index = (dump_index + 1) % FLIGHT_RECORDER_LENGTH;
+        --dump_remaining;
+    }
+    uart_set_RECORDER_REP_remaining(rep, dump_remaining);
+    if (dump_remaining == 0)
+    {
+        dumping = 0;
+    }
+    return OK;
+}
@@ -0,0 +1,50 @@
+/**
+ * \file        Flight_Recorder.h
+ * \brief       Detaylı bilgiyi Flight_Recorder.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef COMMUNICATIONS_FLIGHT_RECORDER_H_
+#define COMMUNICATIONS_FLIGHT_RECORDER_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "autonomousVehicle_conf.h"
+#include "Communication_Mechanism.h"
+/*------------------------------< Defines >-----------------------------------*/
+#define FLIGHT_RECORDER_LENGTH (4000)     //kayıt sayısı, 16 byte lık kayıtlarla CCMRAM in ~62.5 KB ı
+#define FLIGHT_RECORDER_NO_ENTRY (0xFF)     //boş buffer dump edilirken gönderilen kaydın result değeri
+#define FLIGHT_RECORDER_MAGIC  (0x464C5243)     //"FLRC", resetten sonra CCMRAM deki kaydın geçerli olduğunu gösterir
+/*------------------------------< Typedefs >----------------------------------*/
+struct FLIGHT_RECORDER_ENTRY
+{
+    uint32_t tick;       //requestin receive threadine ulaştığı tick
+    uint32_t cycles;     //controllerın requesti işlemesi, DWT cycle
+    uart_req req;
+    uint8_t seq;
+    uint8_t validity;
+    uint8_t result;      //ACK_RESULT
+}__attribute__((packed, aligned(1)));
+
+typedef struct FLIGHT_RECORDER_ENTRY flight_recorder_entry;
+/*------------------------------< Constants >---------------------------------*/
+_Static_assert(sizeof(flight_recorder_entry) == UART_RECORDER_ENTRY_SIZE,
+        "UART_RECORDER_ENTRY_SIZE does not match flight_recorder_entry");
+/*------------------------------< Prototypes >--------------------------------*/
+void flight_recorder_init ( );
+void flight_recorder_record (const communication_msg* msg, enum ACK_RESULT result, uint32_t cycles);
+uint16_t flight_recorder_start_dump ( );
+uint8_t flight_recorder_is_dumping ( );
+Return_Status flight_recorder_dump_next (uart_rep* rep);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* COMMUNICATIONS_FLIGHT_RECORDER_H_ */
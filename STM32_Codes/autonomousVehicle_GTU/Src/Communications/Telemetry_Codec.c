@@ -0,0 +1,369 @@
+/**
+ * \file        Telemetry_Codec.c
+ * \brief       Telemetri snapshotlarını delta olarak sıkıştırır ve açar.
+ *              Ardışık snapshotlarda alanların çoğu değişmez. Bu yüzden her TELEMETRY_CODEC_KEYFRAME_INTERVAL örnekte bir
+ *              tam TELEMETRY_REP (keyframe) gönderilir, aradaki örnekler TELEMETRY_DELTA_REP içinde sadece değişen
+ *              alanlarıyla gönderilir. Her örnek bir mask (bit i: alan i değişti) ve değişen her alan için
+ *              zig-zag kodlanmış farkın varint ini (7 bit veri, en üst bit devam) içerir. Mask da varint tir, sadece
+ *              ilk 7 alan değiştiyse 1 byte tır. Değişmeyen bir örnek 1 byte dır.
+ *              tick ve time her periyotta aynı miktar artar, steer_rate sabit ivmeyle değişir, bu yüzden bu alanlar
+ *              için bir önceki farktan sapma gönderilir. steer için tahmin önceki ve şimdiki steer_rate in ortalamasının
+ *              time farkıyla çarpımıdır, motor hareket ederken sadece yuvarlama farkı kalır. Decoder steer i
+ *              steer_rate ve time dan sonra açar. Bir çerçeveye payload dolana kadar birden fazla örnek konulabilir.
+ *              Çerçevedeki index, ilk örneğin son keyframe den beri numarasıdır. Decoder beklediği numarayı
+ *              görmezse (bir çerçeve kaybolduysa) bir sonraki keyframe e kadar örnek üretmez.
+ *              Dosya Host_Codes altındaki araçlarda decoder olarak da kullanılır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "Telemetry_Codec.h"
+#include "UART_Frame.h"
+#include <string.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define TELEMETRY_CODEC_MASK_MAX_SIZE (2)
+#define TELEMETRY_CODEC_SAMPLE_MAX_SIZE (TELEMETRY_CODEC_MASK_MAX_SIZE + 5 + 5 + 3 + 3 + 2 + 3 + 2 + 2 + 3 + 3 + 2 + 3)     //mask ve en uzun varintler
+/*------------------------------< Typedefs >----------------------------------*/
+enum TELEMETRY_CODEC_PREDICTOR
+{
+    TELEMETRY_CODEC_PREDICT_NONE = 0,     //fark gönderilir
+    TELEMETRY_CODEC_PREDICT_DELTA = 1,     //bir önceki farktan sapma gönderilir
+    TELEMETRY_CODEC_PREDICT_RATE = 2     //steer_rate in time farkı boyunca integralinden sapma gönderilir
+};
+
+struct TELEMETRY_CODEC_FIELD_INFO
+{
+    uint8_t bits;
+    uint8_t predictor;     //TELEMETRY_CODEC_PREDICTOR
+};
+/*------------------------------< Constants >---------------------------------*/
+static const struct TELEMETRY_CODEC_FIELD_INFO field_info[TELEMETRY_CODEC_FIELD_COUNT] = {
+        [TELEMETRY_CODEC_TICK] = { 32, TELEMETRY_CODEC_PREDICT_DELTA },
+        [TELEMETRY_CODEC_TIME] = { 32, TELEMETRY_CODEC_PREDICT_DELTA },
+        [TELEMETRY_CODEC_STEER] = { 16, TELEMETRY_CODEC_PREDICT_RATE },
+        [TELEMETRY_CODEC_THROTTLE] = { 16, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_BRAKE] = { 8, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_DISTANCE] = { 16, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_RX_QUEUE] = { 8, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_TX_QUEUE] = { 8, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_STEER_TARGET] = { 16, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_STEER_RATE] = { 16, TELEMETRY_CODEC_PREDICT_DELTA },
+        [TELEMETRY_CODEC_STEER_MOVING] = { 8, TELEMETRY_CODEC_PREDICT_NONE },
+        [TELEMETRY_CODEC_EXPIRED] = { 16, TELEMETRY_CODEC_PREDICT_NONE } };
+
+_Static_assert(TELEMETRY_CODEC_MAX_SIZE <= UART_FRAME_MAX_PAYLOAD_SIZE, "TELEMETRY_CODEC_MAX_SIZE does not fit in a frame");
+_Static_assert(TELEMETRY_CODEC_FIELD_COUNT <= 7 * TELEMETRY_CODEC_MASK_MAX_SIZE, "telemetry mask does not fit in its varint");
+/*------------------------------< Variables >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+static void telemetry_codec_read (const uart_rep* snapshot, uint32_t* value);
+static void telemetry_codec_write (const uint32_t* value, uart_rep* snapshot);
+static void telemetry_codec_reset (struct TELEMETRY_CODEC_STATE* state, const uart_rep* snapshot);
+static uint32_t telemetry_codec_predict (const struct TELEMETRY_CODEC_STATE* state, const uint32_t* value, uint8_t field);
+static int32_t telemetry_codec_sign_extend (uint32_t value, uint8_t bits);
+/*------------------------------< Functions >---------------------------------*/
+
+/**
+ * Sıradaki snapshot keyframe olarak gönderilir.
+ * */
+void telemetry_encoder_init (telemetry_encoder* encoder)
+{
+    memset(encoder, 0, sizeof(*encoder));
+}
+
+uint8_t telemetry_encoder_is_keyframe_due (const telemetry_encoder* encoder)
+{
+    return !encoder->state.synced || encoder->since_keyframe >= TELEMETRY_CODEC_KEYFRAME_INTERVAL;
+}
+
+/**
+ * snapshot TELEMETRY_REP olarak gönderilecektir, sonraki örneklerin farkı buna göre alınır.
+ * Bekleyen delta çerçevesi daha önce gönderilmiş olmalıdır.
+ * */
+void telemetry_encoder_keyframe (telemetry_encoder* encoder, const uart_rep* snapshot)
+{
+    telemetry_codec_reset(&encoder->state, snapshot);
+    encoder->since_keyframe = 0;
+    encoder->size = 0;
+    encoder->count = 0;
+}
+
+/**
+ * Snapshotı bekleyen delta çerçevesine ekler. Çerçevede yer yoksa hiçbir şey değiştirmeden NOK döner,
+ * çerçeve telemetry_encoder_flush ile gönderildikten sonra tekrar eklenmelidir. Boş çerçeveye ekleme her zaman OK dir.
+ * */
+Return_Status telemetry_encoder_add (telemetry_encoder* encoder, const uart_rep* snapshot)
+{
+    uint8_t sample[TELEMETRY_CODEC_SAMPLE_MAX_SIZE];
+    uint8_t size = TELEMETRY_CODEC_MASK_MAX_SIZE;     //mask varint i alanlardan sonra önlerine yazılır
+    uint8_t start;
+    uint16_t mask = 0;
+    uint32_t value[TELEMETRY_CODEC_FIELD_COUNT];
+    uint32_t delta[TELEMETRY_CODEC_FIELD_COUNT];
+    uint8_t header_size = (encoder->size == 0) ? TELEMETRY_CODEC_HEADER_SIZE : 0;
+
+    telemetry_codec_read(snapshot, value);
+    for (uint8_t i = 0; i < TELEMETRY_CODEC_FIELD_COUNT; ++i)
+    {
+        int32_t residual;
+        uint32_t zigzag;
+
+        delta[i] = value[i] - encoder->state.value[i];
+        residual = telemetry_codec_sign_extend(delta[i] - telemetry_codec_predict(&encoder->state, value, i),
+                field_info[i].bits);
+        if (residual == 0)
+        {
+            continue;
+        }
+        mask |= 1 << i;
+        zigzag = ((uint32_t) residual << 1) ^ (uint32_t) (residual >> 31);
+        while (zigzag >= 0x80)
+        {
+            sample[size++] = (uint8_t) (zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        sample[size++] = (uint8_t) zigzag;
+    }
+    if (mask < 0x80)
+    {
+        start = 1;
+        sample[1] = (uint8_t) mask;
+    }
+    else
+    {
+        start = 0;
+        sample[0] = (uint8_t) (mask | 0x80);
+        sample[1] = (uint8_t) (mask >> 7);
+    }
+    size -= start;
+
+    if (encoder->size + header_size + size > TELEMETRY_CODEC_MAX_SIZE)
+    {
+        return NOK;
+    }
+    if (header_size != 0)
+    {
+        encoder->payload[0] = TELEMETRY_DELTA_REP;
+        encoder->payload[1] = encoder->state.index;
+        encoder->size = TELEMETRY_CODEC_HEADER_SIZE;
+    }
+    memcpy(&encoder->payload[encoder->size], &sample[start], size);
+    encoder->size += size;
+    ++encoder->count;
+    memcpy(encoder->state.value, value, sizeof(value));
+    memcpy(encoder->state.delta, delta, sizeof(delta));
+    ++encoder->state.index;
+    ++encoder->since_keyframe;
+    return OK;
+}
+
+/**
+ * Bekleyen delta çerçevesini payload a kopyalar ve boyutunu döner. Bekleyen örnek yoksa 0 döner.
+ * payload en az TELEMETRY_CODEC_MAX_SIZE byte olmalıdır.
+ * */
+uint8_t telemetry_encoder_flush (telemetry_encoder* encoder, uint8_t* payload)
+{
+    uint8_t size = encoder->size;
+
+    memcpy(payload, encoder->payload, size);
+    encoder->size = 0;
+    encoder->count = 0;
+    return size;
+}
+
+void telemetry_decoder_init (telemetry_decoder* decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/**
+ * Her TELEMETRY_REP bir keyframe dir, delta çözmeden bağımsız olarak host a aynen verilebilir.
+ * */
+void telemetry_decoder_keyframe (telemetry_decoder* decoder, const uart_rep* snapshot)
+{
+    telemetry_codec_reset(&decoder->state, snapshot);
+}
+
+/**
+ * TELEMETRY_DELTA_REP payload unu açar, snapshotları TELEMETRY_REP olarak yazar ve sayısını döner.
+ * Keyframe yoksa, bir çerçeve kaybolduysa veya payload bozuksa 0 döner ve sıradaki keyframe beklenir.
+ * Çerçevede max_snapshots tan fazla örnek varsa kalanlar atlanır ve senkron bozulur,
+ * TELEMETRY_CODEC_MAX_SAMPLES yeterlidir.
+ * */
+uint8_t telemetry_decoder_decode (telemetry_decoder* decoder, const uint8_t* payload, uint8_t size,
+        uart_rep* snapshots, uint8_t max_snapshots)
+{
+    struct TELEMETRY_CODEC_STATE* state = &decoder->state;
+    uint8_t offset = TELEMETRY_CODEC_HEADER_SIZE;
+    uint8_t count = 0;
+
+    if (size <= TELEMETRY_CODEC_HEADER_SIZE || payload[0] != TELEMETRY_DELTA_REP || !state->synced
+            || payload[1] != state->index)
+    {
+        state->synced = 0;
+        ++decoder->lost_frames;
+        return 0;
+    }
+    while (offset < size)
+    {
+        uint16_t mask = payload[offset++];
+
+        if (mask & 0x80)
+        {
+            if (offset == size)
+            {
+                state->synced = 0;
+                ++decoder->lost_frames;
+                return count;
+            }
+            mask = (mask & 0x7F) | ((uint16_t) payload[offset++] << 7);
+        }
+        uint32_t residual[TELEMETRY_CODEC_FIELD_COUNT] = { 0 };
+        uint32_t value[TELEMETRY_CODEC_FIELD_COUNT];
+
+        if (count == max_snapshots)
+        {
+            state->synced = 0;
+            ++decoder->lost_frames;
+            return count;
+        }
+        for (uint8_t i = 0; i < TELEMETRY_CODEC_FIELD_COUNT; ++i)
+        {
+            if (mask & (1 << i))
+            {
+                uint32_t zigzag = 0;
+                uint8_t shift = 0;
+                uint8_t byte;
+
+                do
+                {
+                    if (offset == size || shift > 28)
+                    {
+                        state->synced = 0;
+                        ++decoder->lost_frames;
+                        return count;
+                    }
+                    byte = payload[offset++];
+                    zigzag |= (uint32_t) (byte & 0x7F) << shift;
+                    shift += 7;
+                }
+                while (byte & 0x80);
+                residual[i] = (zigzag >> 1) ^ (uint32_t) -(int32_t) (zigzag & 1);
+            }
+        }
+        //steer in tahmini şimdiki steer_rate ve time a bağlıdır, önce diğer alanlar açılır.
+        for (uint8_t pass = 0; pass < 2; ++pass)
+        {
+            for (uint8_t i = 0; i < TELEMETRY_CODEC_FIELD_COUNT; ++i)
+            {
+                uint32_t delta;
+
+                if ((field_info[i].predictor == TELEMETRY_CODEC_PREDICT_RATE) != pass)
+                {
+                    continue;
+                }
+                delta = residual[i] + telemetry_codec_predict(state, value, i);
+                delta = (uint32_t) telemetry_codec_sign_extend(delta, field_info[i].bits);
+                value[i] = (state->value[i] + delta) & (0xFFFFFFFFUL >> (32 - field_info[i].bits));
+            }
+        }
+        for (uint8_t i = 0; i < TELEMETRY_CODEC_FIELD_COUNT; ++i)
+        {
+            state->delta[i] = value[i] - state->value[i];
+        }
+        memcpy(state->value, value, sizeof(value));
+        telemetry_codec_write(state->value, &snapshots[count++]);
+        ++state->index;
+    }
+    return count;
+}
+
+static void telemetry_codec_read (const uart_rep* snapshot, uint32_t* value)
+{
+    value[TELEMETRY_CODEC_TICK] = uart_get_TELEMETRY_REP_tick(snapshot);
+    value[TELEMETRY_CODEC_TIME] = uart_get_TELEMETRY_REP_time(snapshot);
+    value[TELEMETRY_CODEC_STEER] = uart_get_TELEMETRY_REP_steer(snapshot);
+    value[TELEMETRY_CODEC_THROTTLE] = uart_get_TELEMETRY_REP_throttle(snapshot);
+    value[TELEMETRY_CODEC_BRAKE] = uart_get_TELEMETRY_REP_brake_current(snapshot)
+            | (uart_get_TELEMETRY_REP_brake_next(snapshot) << 4);
+    value[TELEMETRY_CODEC_DISTANCE] = uart_get_TELEMETRY_REP_distance(snapshot);
+    value[TELEMETRY_CODEC_RX_QUEUE] = uart_get_TELEMETRY_REP_rx_queue(snapshot);
+    value[TELEMETRY_CODEC_TX_QUEUE] = uart_get_TELEMETRY_REP_tx_queue(snapshot);
+    value[TELEMETRY_CODEC_STEER_TARGET] = uart_get_TELEMETRY_REP_steer_target(snapshot);
+    value[TELEMETRY_CODEC_STEER_RATE] = uart_get_TELEMETRY_REP_steer_rate(snapshot);
+    value[TELEMETRY_CODEC_STEER_MOVING] = uart_get_TELEMETRY_REP_steer_moving(snapshot);
+    value[TELEMETRY_CODEC_EXPIRED] = uart_get_TELEMETRY_REP_expired(snapshot);
+}
+
+static void telemetry_codec_write (const uint32_t* value, uart_rep* snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+    uart_set_TELEMETRY_REP_tick(snapshot, value[TELEMETRY_CODEC_TICK]);
+    uart_set_TELEMETRY_REP_time(snapshot, value[TELEMETRY_CODEC_TIME]);
+    uart_set_TELEMETRY_REP_steer(snapshot, value[TELEMETRY_CODEC_STEER]);
+    uart_set_TELEMETRY_REP_throttle(snapshot, value[TELEMETRY_CODEC_THROTTLE]);
+    uart_set_TELEMETRY_REP_brake_current(snapshot, value[TELEMETRY_CODEC_BRAKE] & 0x0F);
+    uart_set_TELEMETRY_REP_brake_next(snapshot, (value[TELEMETRY_CODEC_BRAKE] >> 4) & 0x0F);
+    uart_set_TELEMETRY_REP_distance(snapshot, value[TELEMETRY_CODEC_DISTANCE]);
+    uart_set_TELEMETRY_REP_rx_queue(snapshot, value[TELEMETRY_CODEC_RX_QUEUE]);
+    uart_set_TELEMETRY_REP_tx_queue(snapshot, value[TELEMETRY_CODEC_TX_QUEUE]);
+    uart_set_TELEMETRY_REP_steer_target(snapshot, value[TELEMETRY_CODEC_STEER_TARGET]);
+    uart_set_TELEMETRY_REP_steer_rate(snapshot, value[TELEMETRY_CODEC_STEER_RATE]);
+    uart_set_TELEMETRY_REP_steer_moving(snapshot, value[TELEMETRY_CODEC_STEER_MOVING]);
+    uart_set_TELEMETRY_REP_expired(snapshot, value[TELEMETRY_CODEC_EXPIRED]);
+}
+
+/**
+ * Keyframe den sonraki ilk örnekte DELTA tahmini yoktur, farkın kendisi gönderilir.
+ * */
+static void telemetry_codec_reset (struct TELEMETRY_CODEC_STATE* state, const uart_rep* snapshot)
+{
+    telemetry_codec_read(snapshot, state->value);
+    memset(state->delta, 0, sizeof(state->delta));
+    state->index = 1;
+    state->synced = 1;
+}
+
+/**
+ * field alanının bu örnekteki tahmini farkını döner. value bu örneğin değerleridir, RATE tahmini için
+ * steer_rate ve time açılmış olmalıdır. Motor sabit ivmeyle hızlanırken aldığı yol ortalama hız çarpı süredir.
+ * */
+static uint32_t telemetry_codec_predict (const struct TELEMETRY_CODEC_STATE* state, const uint32_t* value, uint8_t field)
+{
+    switch (field_info[field].predictor)
+    {
+        case TELEMETRY_CODEC_PREDICT_DELTA:
+        {
+            return state->delta[field];
+        }
+        case TELEMETRY_CODEC_PREDICT_RATE:
+        {
+            int32_t rate = telemetry_codec_sign_extend(state->value[TELEMETRY_CODEC_STEER_RATE], 16)
+                    + telemetry_codec_sign_extend(value[TELEMETRY_CODEC_STEER_RATE], 16);
+            int32_t elapsed = (int32_t) (value[TELEMETRY_CODEC_TIME] - state->value[TELEMETRY_CODEC_TIME]);
+
+            return (uint32_t) (int32_t) ((int64_t) rate * elapsed / 2000000);     //step/s * us
+        }
+        default:
+        {
+            return 0;
+        }
+    }
+}
+
+/**
+ * Alanın genişliğindeki farkı işaretli sayıya çevirir, böylece örneğin steer -1 den 1 e geçerken fark 2 olur.
+ * */
+static int32_t telemetry_codec_sign_extend (uint32_t value, uint8_t bits)
+{
+    uint32_t sign = 1UL << (bits - 1);
+
+    if (bits >= 32)
+    {
+        return (int32_t) value;
+    }
+    value &= (sign << 1) - 1;
+    return (int32_t) (value ^ sign) - (int32_t) sign;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file        Telemetry_Codec.h
+ * \brief       Detaylı bilgiyi Telemetry_Codec.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef COMMUNICATIONS_TELEMETRY_CODEC_H_
+#define COMMUNICATIONS_TELEMETRY_CODEC_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "autonomousVehicle_conf.h"
+#include "UART_Message.h"
+/*------------------------------< Defines >-----------------------------------*/
+// | TELEMETRY_DELTA_REP (1) | index (1) | mask (1-2) | varint ... | mask (1-2) | varint ... |
+#define TELEMETRY_CODEC_MAX_SIZE (32)     //payload, UART_FRAME_MAX_PAYLOAD_SIZE
+#define TELEMETRY_CODEC_HEADER_SIZE (2)
+#define TELEMETRY_CODEC_MAX_SAMPLES (TELEMETRY_CODEC_MAX_SIZE - TELEMETRY_CODEC_HEADER_SIZE)     //değişmeyen örnek 1 byte
+#define TELEMETRY_CODEC_KEYFRAME_INTERVAL (50)     //bu kadar delta örneğinden sonra tam snapshot gönderilir
+/*------------------------------< Typedefs >----------------------------------*/
+//Mask biti alan numarasıdır. Sürüş sırasında sık değişen alanlar önce gelir, mask çoğunlukla 1 byte kalır.
+enum TELEMETRY_CODEC_FIELD
+{
+    TELEMETRY_CODEC_TIME = 0,
+    TELEMETRY_CODEC_STEER = 1,
+    TELEMETRY_CODEC_STEER_RATE = 2,
+    TELEMETRY_CODEC_TX_QUEUE = 3,
+    TELEMETRY_CODEC_STEER_TARGET = 4,
+    TELEMETRY_CODEC_STEER_MOVING = 5,
+    TELEMETRY_CODEC_DISTANCE = 6,
+    TELEMETRY_CODEC_RX_QUEUE = 7,
+    TELEMETRY_CODEC_TICK = 8,
+    TELEMETRY_CODEC_THROTTLE = 9,
+    TELEMETRY_CODEC_BRAKE = 10,     //brake_current | brake_next << 4
+    TELEMETRY_CODEC_EXPIRED = 11,
+    TELEMETRY_CODEC_FIELD_COUNT = 12
+};
+
+struct TELEMETRY_CODEC_STATE
+{
+    uint32_t value[TELEMETRY_CODEC_FIELD_COUNT];     //son örnek
+    uint32_t delta[TELEMETRY_CODEC_FIELD_COUNT];     //son örnekteki değişim, tick ve time için tahmin
+    uint8_t index;     //sıradaki örneğin keyframe den beri numarası
+    uint8_t synced;     //keyframe alındı
+};
+
+struct TELEMETRY_ENCODER
+{
+    struct TELEMETRY_CODEC_STATE state;
+    uint8_t since_keyframe;
+    uint8_t payload[TELEMETRY_CODEC_MAX_SIZE];
+    uint8_t size;     //payload a yazılmış byte sayısı, 0 ise bekleyen çerçeve yok
+    uint8_t count;     //payload daki örnek sayısı
+};
+
+struct TELEMETRY_DECODER
+{
+    struct TELEMETRY_CODEC_STATE state;
+    uint16_t lost_frames;     //index i beklenmeyen veya çözülemeyen delta çerçeveleri
+};
+
+typedef struct TELEMETRY_ENCODER telemetry_encoder;
+typedef struct TELEMETRY_DECODER telemetry_decoder;
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+void telemetry_encoder_init (telemetry_encoder* encoder);
+uint8_t telemetry_encoder_is_keyframe_due (const telemetry_encoder* encoder);
+void telemetry_encoder_keyframe (telemetry_encoder* encoder, const uart_rep* snapshot);
+Return_Status telemetry_encoder_add (telemetry_encoder* encoder, const uart_rep* snapshot);
+uint8_t telemetry_encoder_flush (telemetry_encoder* encoder, uint8_t* payload);
+void telemetry_decoder_init (telemetry_decoder* decoder);
+void telemetry_decoder_keyframe (telemetry_decoder* decoder, const uart_rep* snapshot);
+uint8_t telemetry_decoder_decode (telemetry_decoder* decoder, const uint8_t* payload, uint8_t size,
+        uart_rep* snapshots, uint8_t max_snapshots);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* COMMUNICATIONS_TELEMETRY_CODEC_H_ */
@@ -0,0 +1,59 @@
+/**
+ * \file        Transport.h
+ * \brief       Communication_Mechanism in kullandığı byte akışı arayüzü. Çerçeveleme, ACK, telemetri ve
+ *              controller tarafı hangi hattan gelindiğini bilmez. Araçta uart_transport (USART2 DMA)
+ *              kullanılır, Host_Codes/transport altında aynı arayüzle pty ve SocketCAN backendleri vardır.
+ *              Baud rate kavramı olmayan hatlarda set_baudrate ve is_baudrate_supported NULL bırakılır,
+ *              bu durumda BAUD_REQ reddedilir. Hat hatası sayacı tutmayan backendlerde get_error_count NULL
+ *              bırakılır, DIAG_REQ bu sayaçlar için 0 döner.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef COMMUNICATIONS_TRANSPORT_H_
+#define COMMUNICATIONS_TRANSPORT_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "autonomousVehicle_conf.h"
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+enum TRANSPORT_ERROR
+{
+    TRANSPORT_ERROR_OVERRUN = 0,     //yeni byte geldiğinde önceki byte henüz okunmamıştı
+    TRANSPORT_ERROR_FRAMING = 1,     //stop biti beklenen yerde bulunamadı
+    TRANSPORT_ERROR_NOISE = 2,
+    TRANSPORT_ERROR_PARITY = 3,
+    TRANSPORT_ERROR_RX_OVERFLOW = 4,     //receive buffer okunmadan doldu, okunmamış byte lar atıldı
+    TRANSPORT_ERROR_COUNT = 5
+};
+
+struct TRANSPORT
+{
+    void (*init) ( );
+    void (*transmit) (const uint8_t* msg, uint8_t msg_len);     //bloklamaz, gönderim arka planda yapılır
+    Return_Status (*receive) (uint8_t* msg, uint8_t msg_len);     //msg_len byte gelene kadar bekler
+    uint16_t (*read) (uint8_t* buf, uint16_t max_len);     //gelen byteları döner, en fazla receive timeout kadar bekler
+    uint32_t (*get_rx_cycle) ( );     //son byte ın geldiği DWT cycle, gecikme ölçümü için
+    Return_Status (*set_baudrate) (uint32_t baudrate);
+    uint8_t (*is_baudrate_supported) (uint32_t baudrate);
+    uint32_t default_baudrate;     //anlaşma başarısız olursa dönülen hız
+    uint16_t (*get_error_count) (enum TRANSPORT_ERROR error);     //açılıştan beri, 0xFFFF ten sonra başa döner
+};
+
+typedef struct TRANSPORT transport;
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* COMMUNICATIONS_TRANSPORT_H_ */
@@ -1,6 +1,14 @@
 /**
  * \file        UART_Communication.c
- * \brief       A brief description one line.
+ * \brief       USART2 üzerinden gelen veriler DMA ile circular bir buffera yazılır.
+ *              DMA yarım/tam transfer kesmeleri ve UART IDLE line kesmesi geldiğinde
+ *              receive threadi uyandırılır. Böylece thread boş hattı beklerken CPU harcamaz
+ *              ve byte geldiği anda queue ya aktarılır.
+ *              Gönderilecek veriler ise bir ring buffera yazılır ve DMA ile gönderilir.
+ *              TX ve RX yolları birbirinden bağımsızdır, ortak bir semaphore kullanılmaz.
+ *              Overrun, framing, noise ve parity hataları kesme içinde sayılıp temizlenir,
+ *              DMA receive durdurulmaz. Receive threadi yetişemez ve DMA okunmamış byte ların
+ *              üzerine yazarsa buffer atılır ve TRANSPORT_ERROR_RX_OVERFLOW sayılır.
  *
  * \author      ahmet.alperen.bulut
  * \date        Aug 17, 2019
@@ -10,47 +18,421 @@
 #include "cmsis_os.h"
 #include "UART_Communication.h"
 #include "main.h"
+#include "helpers.h"
 
 /*------------------------------< Defines >-----------------------------------*/
-#define SEMAPHORE_TIMEOUT (3000)
+#define UART_RX_ERROR_FLAGS (USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)
+#define UART_RX_DMA_WAIT (100)     //RXNE nin DMA tarafından temizlenmesi için en fazla bakma sayısı
 /*------------------------------< Typedefs >----------------------------------*/
 
 /*------------------------------< Constants >---------------------------------*/
+_Static_assert((UART_RX_DMA_BUFFER_SIZE & (UART_RX_DMA_BUFFER_SIZE - 1)) == 0,
+        "RX byte counters wrap at 2^32, buffer index is counter % size");
 
+const transport uart_transport =
+{
+    .init = uart_init,
+    .transmit = uart_transmit,
+    .receive = uart_receive,
+    .read = uart_read,
+    .get_rx_cycle = uart_get_rx_cycle,
+    .set_baudrate = uart_set_baudrate,
+    .is_baudrate_supported = uart_is_baudrate_supported,
+    .default_baudrate = UART_DEFAULT_BAUDRATE,
+    .get_error_count = uart_get_error_count,
+};
 /*------------------------------< Variables >---------------------------------*/
-static StaticSemaphore_t xSemaphoreBuffer;
-static SemaphoreHandle_t xSemaphore;
-/*------------------------------< Prototypes >--------------------------------*/
+static StaticSemaphore_t xTxSemaphoreBuffer;
+static SemaphoreHandle_t xTxSemaphore;     //DMA gönderimi bittiğinde ring bufferda yer bekleyen threadi uyandırır.
+
+static StaticSemaphore_t xRxSemaphoreBuffer;
+static SemaphoreHandle_t xRxSemaphore;     //DMA veya IDLE kesmesi geldiğinde receive threadini uyandırır.
 
+static uint8_t uart_rx_dma_buffer[UART_RX_DMA_BUFFER_SIZE];
+static volatile uint32_t uart_rx_written;     //DMA nın yazdığı toplam byte, kesmelerde güncellenir
+static uint32_t uart_rx_consumed;     //receive threadinin okuduğu veya attığı toplam byte, kritik bölgede değişir
+static volatile uint32_t uart_rx_cycle;     //en son receive kesmesinin DWT cycle değeri
+static volatile uint16_t uart_error_count[TRANSPORT_ERROR_COUNT];
+
+static uint8_t uart_tx_ring_buffer[UART_TX_RING_BUFFER_SIZE];
+static volatile uint16_t uart_tx_head;     //Bir sonraki byte ın yazılacağı index
+static volatile uint16_t uart_tx_tail;     //DMA ile gönderilmeyi bekleyen ilk byte ın indexi
+static volatile uint16_t uart_tx_dma_len;     //O an DMA ile gönderilen byte sayısı, 0 ise DMA boşta
+/*------------------------------< Prototypes >--------------------------------*/
+static void uart_rx_start ( );
+static uint16_t uart_rx_write_index ( );
+static uint16_t uart_rx_pending ( );
+static uint16_t uart_rx_available ( );
+static uint16_t uart_rx_take (uint8_t * buf, uint16_t max_len);
+static void uart_rx_clear_flags ( );
+static void uart_rx_notify_from_isr ( );
+static uint16_t uart_tx_free ( );
+static uint8_t uart_tx_idle ( );
+static void uart_tx_kick ( );
 /*------------------------------< Functions >---------------------------------*/
 
 void uart_init ( )
 {
-    xSemaphore = xSemaphoreCreateCountingStatic(1, 1, &xSemaphoreBuffer);
+    xTxSemaphore = xSemaphoreCreateBinaryStatic(&xTxSemaphoreBuffer);
+    xRxSemaphore = xSemaphoreCreateBinaryStatic(&xRxSemaphoreBuffer);
+    uart_rx_start( );
 }
 
-void uart_transmit (uint8_t * msg, uint8_t msg_len)
+/**
+ * Mesajı TX ring bufferına kopyalar ve DMA boştaysa gönderimi başlatır.
+ * Gönderimin bitmesini beklemez. Bufferda yer yoksa UART_TRANSMIT_TIMEOUT kadar yer açılmasını bekler.
+ * */
+void uart_transmit (const uint8_t * msg, uint8_t msg_len)
 {
-    if (osSemaphoreWait(xSemaphore, SEMAPHORE_TIMEOUT) >= 0)
+    uint8_t i;
+
+    while (uart_tx_free( ) < msg_len)
     {
-        HAL_UART_Transmit(&huart2, (uint8_t *) msg, msg_len, UART_TRANSMIT_TIMEOUT);
+        if (xSemaphoreTake(xTxSemaphore, (TickType_t) UART_TRANSMIT_TIMEOUT) != pdTRUE)
+        {
+            return;
+        }
     }
-    osSemaphoreRelease(xSemaphore);
+
+    for (i = 0; i < msg_len; ++i)
+    {
+        uart_tx_ring_buffer[uart_tx_head] = msg[i];
+        uart_tx_head = (uart_tx_head + 1) % UART_TX_RING_BUFFER_SIZE;
+    }
+
+    taskENTER_CRITICAL();
+    uart_tx_kick( );
+    taskEXIT_CRITICAL();
     return;
 }
 
+/**
+ * DMA circular bufferdan msg_len kadar byte okur. Yeterli byte yoksa kesme gelene kadar bekler.
+ * UART_RECEIVE_TIMEOUT süresince yeni byte gelmezse yarım kalan paket atılır.
+ * */
 Return_Status uart_receive (uint8_t * msg, uint8_t msg_len)
 {
-    Return_Status ret_val = NOK;
-    if (osSemaphoreWait(xSemaphore, SEMAPHORE_TIMEOUT) >= 0)
+    while (uart_rx_available( ) < msg_len)
+    {
+        if (xSemaphoreTake(xRxSemaphore, (TickType_t) UART_RECEIVE_TIMEOUT) != pdTRUE)
+        {
+            uart_rx_take(NULL, UART_RX_DMA_BUFFER_SIZE);
+            return NOK;
+        }
+    }
+    //Arada receive yeniden başlatıldıysa byte lar atılmıştır, yarım kalan paket gibi davranılır.
+    return (uart_rx_take(msg, msg_len) == msg_len) ? OK : NOK;
+}
+
+/**
+ * DMA circular bufferda o an bulunan byteları (en fazla max_len kadar) buf a kopyalar.
+ * Buffer boşsa UART_RECEIVE_TIMEOUT kadar byte gelmesini bekler. Okunan byte sayısını döner.
+ * */
+uint16_t uart_read (uint8_t * buf, uint16_t max_len)
+{
+    while (uart_rx_available( ) == 0)
     {
-        if (HAL_UART_Receive(&huart2, (uint8_t *) msg, msg_len, (TickType_t) UART_RECEIVE_TIMEOUT)
-                == HAL_OK)
+        if (xSemaphoreTake(xRxSemaphore, (TickType_t) UART_RECEIVE_TIMEOUT) != pdTRUE)
         {
-            ret_val = OK;
+            return 0;
         }
     }
-    osSemaphoreRelease(xSemaphore);
-    return ret_val;
+    return uart_rx_take(buf, max_len);
+}
+
+/**
+ * USART2_IRQHandler içinde HAL_UART_IRQHandler dan önce çağrılır.
+ * ORE, FE, NE ve PE bayrakları HAL e bırakılırsa HAL circular DMA receive i durdurur ve hat
+ * ErrorCallback ile tekrar başlatılana kadar sağır kalır, okunmamış byte lar da kaybolur.
+ * Bu yüzden hatalar burada sayılır ve uart_rx_clear_flags ile temizlenir, DMA çalışmaya devam eder.
+ * Overrun da kaybolan byte ın olduğu çerçeve CRC kontrolünde elenir.
+ * Hat boşa çıktığında DMA nın yarım/tam dolmasını beklemeden receive threadi uyandırılır.
+ * */
+void uart_irq_handler ( )
+{
+    uint32_t sr = huart2.Instance->SR;
+
+    if ((sr & UART_RX_ERROR_FLAGS) != 0)
+    {
+        if (sr & USART_SR_ORE)
+        {
+            ++uart_error_count[TRANSPORT_ERROR_OVERRUN];
+        }
+        if (sr & USART_SR_FE)
+        {
+            ++uart_error_count[TRANSPORT_ERROR_FRAMING];
+        }
+        if (sr & USART_SR_NE)
+        {
+            ++uart_error_count[TRANSPORT_ERROR_NOISE];
+        }
+        if (sr & USART_SR_PE)
+        {
+            ++uart_error_count[TRANSPORT_ERROR_PARITY];
+        }
+    }
+    if ((sr & (UART_RX_ERROR_FLAGS | USART_SR_IDLE)) != 0)
+    {
+        uart_rx_clear_flags( );
+    }
+    if ((sr & USART_SR_IDLE) != 0 && __HAL_UART_GET_IT_SOURCE(&huart2, UART_IT_IDLE) != RESET)
+    {
+        uart_rx_notify_from_isr( );
+    }
+}
+
+uint16_t uart_get_error_count (enum TRANSPORT_ERROR error)
+{
+    return (error < TRANSPORT_ERROR_COUNT) ? uart_error_count[error] : 0;
+}
+
+/**
+ * En son byte ların geldiği (receive threadinin uyandırıldığı) andaki DWT cycle değerini döner.
+ * */
+uint32_t uart_get_rx_cycle ( )
+{
+    return uart_rx_cycle;
+}
+
+/**
+ * TX ring bufferdaki her şey gönderilip son byte hattan çıktıktan sonra BRR yeniden yazılır.
+ * RX DMA durdurulmaz; geçiş sırasında bozulan byte ları parser atar.
+ * TX en fazla UART_TRANSMIT_TIMEOUT kadar beklenir, boşalmazsa hız yine de değiştirilir.
+ * */
+Return_Status uart_set_baudrate (uint32_t baudrate)
+{
+    uint32_t pclk = HAL_RCC_GetPCLK1Freq( );
+    uint16_t wait;
+
+    if (!uart_is_baudrate_supported(baudrate))
+    {
+        return NOK;
+    }
+    for (wait = 0; wait < UART_TRANSMIT_TIMEOUT && !uart_tx_idle( ); ++wait)
+    {
+        osDelay(1);
+    }
+
+    taskENTER_CRITICAL();
+    huart2.Init.BaudRate = baudrate;
+    huart2.Instance->BRR = UART_BRR_SAMPLING16(pclk, baudrate);
+    taskEXIT_CRITICAL();
+    return OK;
+}
+
+uint8_t uart_is_baudrate_supported (uint32_t baudrate)
+{
+    return baudrate >= UART_MIN_BAUDRATE && baudrate <= UART_MAX_BAUDRATE
+            && baudrate <= HAL_RCC_GetPCLK1Freq( ) / 16;
+}
+
+uint32_t uart_get_baudrate ( )
+{
+    return huart2.Init.BaudRate;
+}
+
+void HAL_UART_TxCpltCallback (UART_HandleTypeDef *huart)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if (huart->Instance == USART2)
+    {
+        uart_tx_tail = (uart_tx_tail + uart_tx_dma_len) % UART_TX_RING_BUFFER_SIZE;
+        uart_tx_dma_len = 0;
+        uart_tx_kick( );
+        xSemaphoreGiveFromISR(xTxSemaphore, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+}
+
+void HAL_UART_RxHalfCpltCallback (UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART2)
+    {
+        uart_rx_notify_from_isr( );
+    }
+}
+
+void HAL_UART_RxCpltCallback (UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART2)
+    {
+        uart_rx_notify_from_isr( );
+    }
+}
+
+/**
+ * Hat hataları uart_irq_handler da temizlendiği için buraya DMA transfer hatası gibi durumlarda
+ * veya bayrak iki okuma arasında set olduğunda düşülür. HAL DMA receive i durdurmuştur,
+ * circular receive tekrar başlatılmazsa hattan bir daha veri alınamaz.
+ * */
+void HAL_UART_ErrorCallback (UART_HandleTypeDef *huart)
+{
+    if (huart->Instance != USART2)
+    {
+        return;
+    }
+    if (huart->RxState == HAL_UART_STATE_READY)
+    {
+        uart_rx_start( );
+        uart_rx_notify_from_isr( );
+    }
+    if (huart->gState == HAL_UART_STATE_READY && uart_tx_dma_len != 0)
+    {
+        //Yarım kalan DMA gönderimi baştan tekrar başlatılır.
+        uart_tx_dma_len = 0;
+        uart_tx_kick( );
+    }
+}
+
+/**
+ * uart_init ten ve kesme içinden (HAL_UART_ErrorCallback) çağrılır. Receive threadi sayaçları kritik bölgede
+ * okuyup yazar, sayaçlar ve DMA index i o bölgenin ortasında değişmesin diye kesme maskesi altında sıfırlanır.
+ * */
+static void uart_rx_start ( )
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+    uart_rx_written = 0;
+    uart_rx_consumed = 0;
+    HAL_UART_Receive_DMA(&huart2, uart_rx_dma_buffer, UART_RX_DMA_BUFFER_SIZE);
+    uart_rx_clear_flags( );
+    __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+/**
+ * DMA nın yazdığı index NDTR registerından hesaplanır.
+ * */
+static uint16_t uart_rx_write_index ( )
+{
+    return (UART_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart2.hdmarx)) % UART_RX_DMA_BUFFER_SIZE;
+}
+
+/**
+ * Sadece index lere bakılırsa DMA okuma index ini geçtiğinde buffer boş veya az dolu görünür.
+ * Bu yüzden DMA nın yazdığı byte lar yarım/tam transfer ve IDLE kesmelerinde uart_rx_written a eklenir.
+ * Kesmeler arasında en fazla yarım buffer yazılır, NDTR farkı belirsiz olmaz. Okunmamış byte sayısı
+ * buffer boyutunu aştıysa eski byte ların üzerine yazılmıştır: hepsi atılır, parser bir sonraki SOF ta
+ * senkronize olur ve taşma sayılır. Tam buffer boyutu kadar byte henüz geçerlidir.
+ * Kritik bölge içinden çağrılmalıdır.
+ * */
+static uint16_t uart_rx_pending ( )
+{
+    uint32_t pending = uart_rx_written + (uart_rx_write_index( ) - uart_rx_written) % UART_RX_DMA_BUFFER_SIZE
+            - uart_rx_consumed;
+
+    if (pending > UART_RX_DMA_BUFFER_SIZE)
+    {
+        ++uart_error_count[TRANSPORT_ERROR_RX_OVERFLOW];
+        uart_rx_consumed += pending;
+        pending = 0;
+    }
+    return pending;
+}
+
+static uint16_t uart_rx_available ( )
+{
+    uint16_t pending;
+
+    taskENTER_CRITICAL();
+    pending = uart_rx_pending( );
+    taskEXIT_CRITICAL();
+    return pending;
+}
+
+/**
+ * Okunmamış byte lardan en fazla max_len kadarını buf a kopyalar (buf NULL ise atar) ve sayısını döner.
+ * Sayma ve kopyalama aynı kritik bölgededir, uart_rx_start sayaçları arada sıfırlayamaz.
+ * En fazla bir buffer kopyalanır, bu birkaç us sürer.
+ * */
+static uint16_t uart_rx_take (uint8_t * buf, uint16_t max_len)
+{
+    uint16_t len;
+    uint16_t i;
 
+    taskENTER_CRITICAL();
+    len = uart_rx_pending( );
+    if (len > max_len)
+    {
+        len = max_len;
+    }
+    for (i = 0; buf != NULL && i < len; ++i)
+    {
+        buf[i] = uart_rx_dma_buffer[(uart_rx_consumed + i) % UART_RX_DMA_BUFFER_SIZE];
+    }
+    uart_rx_consumed += len;
+    taskEXIT_CRITICAL();
+    return len;
+}
+
+/**
+ * ORE, FE, NE, PE ve IDLE, SR okumasından sonraki ilk DR okumasıyla temizlenir. DR de DMA nın henüz almadığı
+ * bir byte varsa (RXNE) yazılımın DR okuması onu tüketir ve byte buffer a hiç yazılmaz. Bu yüzden RXNE set ise
+ * DMA nın byte ı almasını beklenir: dizinin ikinci adımı DMA nın DR okumasıdır ve bayrakları o temizler.
+ * RXNE 0 iken DR de alınmamış byte yoktur, DR okuması veri kaybettirmez. Kesme içinden veya kesmeler
+ * maskeliyken çağrılmalıdır.
+ * */
+static void uart_rx_clear_flags ( )
+{
+    uint32_t sr;
+    uint16_t wait = UART_RX_DMA_WAIT;
+
+    while (((sr = huart2.Instance->SR) & USART_SR_RXNE) != 0 && wait > 0)
+    {
+        --wait;
+    }
+    if ((sr & (UART_RX_ERROR_FLAGS | USART_SR_IDLE)) != 0 && (sr & USART_SR_RXNE) == 0)
+    {
+        (void) huart2.Instance->DR;
+    }
+}
+
+static void uart_rx_notify_from_isr ( )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uart_rx_written += (uart_rx_write_index( ) - uart_rx_written) % UART_RX_DMA_BUFFER_SIZE;
+    uart_rx_cycle = cycle_counter_get( );
+    if (xRxSemaphore != NULL)
+    {
+        xSemaphoreGiveFromISR(xRxSemaphore, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+}
+
+static uint16_t uart_tx_free ( )
+{
+    return UART_TX_RING_BUFFER_SIZE - 1
+            - (uart_tx_head + UART_TX_RING_BUFFER_SIZE - uart_tx_tail) % UART_TX_RING_BUFFER_SIZE;
+}
+
+static uint8_t uart_tx_idle ( )
+{
+    return uart_tx_dma_len == 0 && uart_tx_head == uart_tx_tail
+            && __HAL_UART_GET_FLAG(&huart2, UART_FLAG_TC) != RESET;
+}
+
+/**
+ * DMA boştaysa ring bufferdaki ardışık (wrap olmayan) ilk parçayı göndermeye başlar.
+ * Kesme içinden veya critical section içinden çağrılmalıdır.
+ * */
+static void uart_tx_kick ( )
+{
+    uint16_t head = uart_tx_head;
+
+    if (uart_tx_dma_len != 0 || head == uart_tx_tail)
+    {
+        return;
+    }
+    if (head > uart_tx_tail)
+    {
+        uart_tx_dma_len = head - uart_tx_tail;
+    }
+    else
+    {
+        uart_tx_dma_len = UART_TX_RING_BUFFER_SIZE - uart_tx_tail;
+    }
+    if (HAL_UART_Transmit_DMA(&huart2, &uart_tx_ring_buffer[uart_tx_tail], uart_tx_dma_len) != HAL_OK)
+    {
+        uart_tx_dma_len = 0;
+    }
 }
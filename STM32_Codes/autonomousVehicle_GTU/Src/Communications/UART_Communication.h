@@ -15,17 +15,32 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 
 /*------------------------------< Includes >----------------------------------*/
 #include "autonomousVehicle_conf.h"
+#include "Transport.h"
 /*------------------------------< Defines >-----------------------------------*/
 #define UART_TRANSMIT_TIMEOUT (500)
-#define UART_RECEIVE_TIMEOUT (700)
+#ifndef UART_RECEIVE_TIMEOUT
+#define UART_RECEIVE_TIMEOUT (700)     //bilgisayardaki karşılığı PTY_TRANSPORT_RECEIVE_TIMEOUT
+#endif
+#define UART_RX_DMA_BUFFER_SIZE (256)     //DMA circular receive buffer boyutu
+#define UART_TX_RING_BUFFER_SIZE (256)     //DMA ile gönderilecek verilerin ring buffer boyutu
+#define UART_DEFAULT_BAUDRATE (115200)     //MX_USART2_UART_Init deki hız, anlaşma başarısız olursa buna dönülür
+#define UART_MIN_BAUDRATE (9600)
+#define UART_MAX_BAUDRATE (2000000)     //APB1 42 MHz, 16 oversampling ile BRR = 21, hatasız
 /*------------------------------< Typedefs >----------------------------------*/
 
 /*------------------------------< Constants >---------------------------------*/
-
+extern const transport uart_transport;
 /*------------------------------< Prototypes >--------------------------------*/
 void uart_init ( );
-void uart_transmit (uint8_t * msg, uint8_t msg_len);
+void uart_transmit (const uint8_t * msg, uint8_t msg_len);
 Return_Status uart_receive (uint8_t * msg, uint8_t msg_len);
+uint16_t uart_read (uint8_t * buf, uint16_t max_len);
+void uart_irq_handler ( );
+uint32_t uart_get_rx_cycle ( );
+Return_Status uart_set_baudrate (uint32_t baudrate);
+uint8_t uart_is_baudrate_supported (uint32_t baudrate);
+uint32_t uart_get_baudrate ( );
+uint16_t uart_get_error_count (enum TRANSPORT_ERROR error);
 
 #if defined(__cplusplus)
 }                /* Make sure we have C-declarations in C++ programs */
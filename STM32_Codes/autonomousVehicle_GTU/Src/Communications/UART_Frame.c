@@ -0,0 +1,196 @@
+/**
+ * \file        UART_Frame.c
+ * \brief       UART mesajları SOF, uzunluk, sıra numarası, payload ve CRC den oluşan bir çerçeve içinde gönderilir.
+ *              Bir byte kaybolduğunda veya bozulduğunda parser bir sonraki SOF a kayarak
+ *              en geç bir çerçeve sonra tekrar senkronize olur.
+ *              CRC, STM32F4 ün donanım CRC birimi ile hesaplanır (CRC-32, polinom 0x04C11DB7,
+ *              başlangıç 0xFFFFFFFF). Her byte 32 bitlik bir word olarak birime yazılır,
+ *              sonucun düşük 16 biti çerçeveye eklenir.
+ *              UART_FRAME_SOFTWARE_CRC ile aynı CRC yazılımla hesaplanır, böylece bu dosya
+ *              Host_Codes altındaki araçlarda da kullanılabilir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "UART_Frame.h"
+#include "cmsis_os.h"
+#include <string.h>
+/*------------------------------< Defines >-----------------------------------*/
+#define UART_FRAME_SIZE(payload_len) ((payload_len) + UART_FRAME_OVERHEAD)
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+static void uart_frame_resync (uart_frame_parser* parser);
+/*------------------------------< Functions >---------------------------------*/
+
+void uart_frame_init ( )
+{
+#if !UART_FRAME_SOFTWARE_CRC
+    __HAL_RCC_CRC_CLK_ENABLE();     //HAL CRC modülü projeye eklenmedi, register a direkt erişiliyor.
+#endif
+}
+
+void uart_frame_parser_init (uart_frame_parser* parser)
+{
+    parser->index = 0;
+    parser->resyncing = 0;
+    parser->crc_errors = 0;
+    parser->length_errors = 0;
+}
+
+/**
+ * Hattan byte kaybolduğu bilindiğinde buffer daki yarım çerçeve atılır, parser bir sonraki SOF u bekler.
+ * Kaybın ortasından gelen byte lar reddedilirken hata sayılmaz, sayaçlar korunur.
+ * */
+void uart_frame_parser_reset (uart_frame_parser* parser)
+{
+    parser->index = 0;
+    parser->resyncing = 1;
+}
+
+/**
+ * Parsera bir byte ekler. Geçerli bir çerçeve tamamlandığında payload u ve sıra numarasını kopyalar ve OK döner.
+ * Bozuk bir çerçeveden sonra payload içindeki SOF benzeri byte lar da reddedilebilir, bu yüzden hata
+ * sayaçları sadece senkron kaybolduğunda, yani geçerli bir çerçeveden sonraki ilk redde artırılır.
+ * OK dönüldüğünde buffer da başka tam çerçeveler kalmış olabilir, uart_frame_parse_next ile alınmalıdır.
+ * */
+Return_Status uart_frame_parse_byte (uart_frame_parser* parser, uint8_t byte, uint8_t* payload,
+        uint8_t* payload_len, uint8_t* seq)
+{
+    if (parser->index == 0 && byte != UART_FRAME_SOF)
+    {
+        return NOK;
+    }
+    parser->buffer[parser->index++] = byte;
+    return uart_frame_parse_next(parser, payload, payload_len, seq);
+}
+
+/**
+ * Yeni byte eklemeden buffer daki ilk tam çerçeveyi çıkarır. Reddedilen bir adaydan sonra buffer da
+ * kalan byte lar birden fazla çerçeve içerebilir. Bunlar bir sonraki byte ı beklemeden, boşta kalan bir
+ * hatta da hemen alınır. Çerçeve yoksa NOK döner.
+ * */
+Return_Status uart_frame_parse_next (uart_frame_parser* parser, uint8_t* payload, uint8_t* payload_len,
+        uint8_t* seq)
+{
+    while (parser->index >= 2)
+    {
+        uint8_t len = parser->buffer[1];
+        uint8_t frame_size = UART_FRAME_SIZE(len);
+        uint16_t crc;
+
+        if (len == 0 || len > UART_FRAME_MAX_PAYLOAD_SIZE)
+        {
+            parser->length_errors += !parser->resyncing;
+            uart_frame_resync(parser);
+            continue;
+        }
+        if (parser->index < frame_size)
+        {
+            return NOK;
+        }
+
+        crc = parser->buffer[frame_size - 2] | (parser->buffer[frame_size - 1] << 8);
+        if (crc != uart_frame_crc(&parser->buffer[1], len + UART_FRAME_HEADER_SIZE - 1))
+        {
+            parser->crc_errors += !parser->resyncing;
+            uart_frame_resync(parser);
+            continue;
+        }
+
+        memcpy(payload, &parser->buffer[UART_FRAME_HEADER_SIZE], len);
+        *payload_len = len;
+        *seq = parser->buffer[2];
+        parser->resyncing = 0;
+        parser->index -= frame_size;
+        memmove(parser->buffer, &parser->buffer[frame_size], parser->index);
+        return OK;
+    }
+    return NOK;
+}
+
+/**
+ * payload u çerçeveleyip frame e yazar. frame en az UART_FRAME_SIZE(payload_len) byte olmalıdır.
+ * Çerçevenin toplam uzunluğunu döner.
+ * */
+uint8_t uart_frame_encode (const uint8_t* payload, uint8_t payload_len, uint8_t seq, uint8_t* frame)
+{
+    uint16_t crc;
+
+    frame[0] = UART_FRAME_SOF;
+    frame[1] = payload_len;
+    frame[2] = seq;
+    memcpy(&frame[UART_FRAME_HEADER_SIZE], payload, payload_len);
+    crc = uart_frame_crc(&frame[1], payload_len + UART_FRAME_HEADER_SIZE - 1);
+    frame[UART_FRAME_HEADER_SIZE + payload_len] = crc & 0xFF;
+    frame[UART_FRAME_HEADER_SIZE + payload_len + 1] = crc >> 8;
+    return UART_FRAME_SIZE(payload_len);
+}
+
+#if UART_FRAME_SOFTWARE_CRC
+/**
+ * CRC biriminin yaptığı gibi her byte 32 bitlik word olarak MSB den başlayarak işlenir.
+ * */
+uint16_t uart_frame_crc (const uint8_t* data, uint8_t len)
+{
+    uint8_t i;
+    uint8_t bit;
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (i = 0; i < len; ++i)
+    {
+        crc ^= data[i];
+        for (bit = 0; bit < 32; ++bit)
+        {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ UART_FRAME_CRC_POLYNOMIAL : (crc << 1);
+        }
+    }
+    return (uint16_t) crc;
+}
+#else
+/**
+ * Donanım CRC birimi hem receive hem transmit threadi tarafından kullanıldığı için
+ * hesaplama critical section içinde yapılır.
+ * */
+uint16_t uart_frame_crc (const uint8_t* data, uint8_t len)
+{
+    uint8_t i;
+    uint32_t crc;
+
+    taskENTER_CRITICAL();
+    CRC->CR = CRC_CR_RESET;
+    for (i = 0; i < len; ++i)
+    {
+        CRC->DR = data[i];
+    }
+    crc = CRC->DR;
+    taskEXIT_CRITICAL();
+    return (uint16_t) crc;
+}
+#endif
+
+/**
+ * Buffer daki ilk SOF atılır ve bir sonraki SOF adayına kayılır.
+ * Aday yoksa buffer boşaltılır.
+ * */
+static void uart_frame_resync (uart_frame_parser* parser)
+{
+    uint8_t i;
+
+    parser->resyncing = 1;
+    for (i = 1; i < parser->index; ++i)
+    {
+        if (parser->buffer[i] == UART_FRAME_SOF)
+        {
+            break;
+        }
+    }
+    parser->index -= i;
+    memmove(parser->buffer, &parser->buffer[i], parser->index);
+}
@@ -0,0 +1,59 @@
+/**
+ * \file        UART_Frame.h
+ * \brief       Detaylı bilgiyi UART_Frame.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef COMMUNICATIONS_UART_FRAME_H_
+#define COMMUNICATIONS_UART_FRAME_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "autonomousVehicle_conf.h"
+/*------------------------------< Defines >-----------------------------------*/
+// | SOF (1) | LEN (1) | SEQ (1) | PAYLOAD (LEN) | CRC (2, little endian) |
+#define UART_FRAME_SOF              (0xA5)
+#define UART_FRAME_HEADER_SIZE      (3)
+#define UART_FRAME_CRC_SIZE         (2)
+#define UART_FRAME_MAX_PAYLOAD_SIZE (32)
+#define UART_FRAME_OVERHEAD         (UART_FRAME_HEADER_SIZE + UART_FRAME_CRC_SIZE)
+#define UART_FRAME_MAX_SIZE         (UART_FRAME_MAX_PAYLOAD_SIZE + UART_FRAME_OVERHEAD)
+#ifndef UART_FRAME_SOFTWARE_CRC
+#define UART_FRAME_SOFTWARE_CRC     (0)     //1 ise CRC birimi yerine aynı sonucu veren yazılım kullanılır, bilgisayarda derlerken
+#endif
+#define UART_FRAME_CRC_POLYNOMIAL   (0x04C11DB7)
+/*------------------------------< Typedefs >----------------------------------*/
+struct UART_FRAME_PARSER
+{
+    uint8_t buffer[UART_FRAME_MAX_SIZE];
+    uint8_t index;     //buffera yazılmış byte sayısı
+    uint8_t resyncing;     //son geçerli çerçeveden beri bir aday reddedildi
+    uint16_t crc_errors;     //CRC si tutmayan çerçeveler
+    uint16_t length_errors;     //LEN alanı 0 veya UART_FRAME_MAX_PAYLOAD_SIZE ten büyük olan çerçeveler
+};
+
+typedef struct UART_FRAME_PARSER uart_frame_parser;
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+void uart_frame_init ( );
+void uart_frame_parser_init (uart_frame_parser* parser);
+void uart_frame_parser_reset (uart_frame_parser* parser);
+Return_Status uart_frame_parse_byte (uart_frame_parser* parser, uint8_t byte, uint8_t* payload,
+        uint8_t* payload_len, uint8_t* seq);
+Return_Status uart_frame_parse_next (uart_frame_parser* parser, uint8_t* payload, uint8_t* payload_len,
+        uint8_t* seq);
+uint8_t uart_frame_encode (const uint8_t* payload, uint8_t payload_len, uint8_t seq, uint8_t* frame);
+uint16_t uart_frame_crc (const uint8_t* data, uint8_t len);
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* COMMUNICATIONS_UART_FRAME_H_ */
@@ -14,7 +14,14 @@
 /*------------------------------< Typedefs >----------------------------------*/
 
 /*------------------------------< Constants >---------------------------------*/
+#define UART_MSG_SIZE(name, id, size, ...) [name] = size,
+#define UART_MSG_SKIP(...)
 
+static const uint8_t req_size[UART_HEADER_COUNT] = { UART_MESSAGE_TABLE(UART_MSG_SIZE, UART_MSG_SKIP) };
+static const uint8_t rep_size[UART_HEADER_COUNT] = { UART_MESSAGE_TABLE(UART_MSG_SKIP, UART_MSG_SIZE) };
+
+#undef UART_MSG_SIZE
+#undef UART_MSG_SKIP
 /*------------------------------< Variables >---------------------------------*/
 
 /*------------------------------< Prototypes >--------------------------------*/
@@ -23,37 +30,135 @@
 
 void create_state_rep_msg (uart_rep* rep, enum STATE val)
 {
-#define STATE_MSG_MASK (0x0003)
-	rep->rep_packed.header = STATE_REP;
-	rep->rep_packed.data = val & STATE_MSG_MASK;
-#undef STATE_MSG_MASK
+	uart_set_STATE_REP_val(rep, val);
 }
 
 void create_general_rep_msg (uart_rep* rep, const uint8_t val)
 {
-#define GENERAL_MSG_MASK (0x0001)
-	rep->rep_packed.header = GENERIC_REP;
-	rep->rep_packed.data = val & GENERAL_MSG_MASK;
-#undef GENERAL_MSG_MASK
+	uart_set_GENERIC_REP_val(rep, val);
+}
+
+void create_control_rep_msg (uart_rep* rep, const uint16_t val)
+{
+	uart_set_CONTROL_REP_val(rep, val);
+}
+
+/**
+ * rx_seq + credits, hostun bekletilmeden kabul edilecek en büyük sıra numarasıdır.
+ * */
+void create_ack_rep_msg (uart_rep* rep, uint8_t seq, uint8_t received, uint16_t results, uint32_t time,
+        uint8_t rx_queue, uint8_t rx_seq, uint8_t credits)
+{
+	uart_set_ACK_REP_seq(rep, seq);
+	uart_set_ACK_REP_received(rep, received);
+	uart_set_ACK_REP_results(rep, results);
+	uart_set_ACK_REP_time(rep, time);
+	uart_set_ACK_REP_rx_queue(rep, rx_queue);
+	uart_set_ACK_REP_rx_seq(rep, rx_seq);
+	uart_set_ACK_REP_credits(rep, credits);
+}
+
+/**
+ * tx_time çerçeve gönderilirken communication_transmit içinde yazılır.
+ * */
+void create_sync_rep_msg (uart_rep* rep, uint32_t host_time, uint32_t rx_time)
+{
+	uart_set_SYNC_REP_host_time(rep, host_time);
+	uart_set_SYNC_REP_rx_time(rep, rx_time);
+}
+
+void create_diag_rep_msg (uart_rep* rep, const uint16_t val)
+{
+	uart_set_DIAG_REP_val(rep, val);
+}
+
+void create_baud_rep_msg (uart_rep* rep, const uint32_t baudrate)
+{
+	uart_set_BAUD_REP_rate(rep, baudrate / UART_BAUD_UNIT);
+}
+
+/**
+ * Tanınmayan headerlar varsayılan boyutta kabul edilir, controller bunlara ACK_UNKNOWN döner.
+ * */
+uint8_t get_req_msg_size (const uart_req* req)
+{
+	if (req->req_packed.header >= UART_HEADER_COUNT || req_size[req->req_packed.header] == 0)
+	{
+		return UART_REQ_SIZE;
+	}
+	return req_size[req->req_packed.header];
+}
+
+uint8_t get_rep_msg_size (const uart_rep* rep)
+{
+	if (rep->rep_packed.header >= UART_HEADER_COUNT || rep_size[rep->rep_packed.header] == 0)
+	{
+		return UART_REP_SIZE;
+	}
+	return rep_size[rep->rep_packed.header];
+}
+
+void parse_ack_config_msg (const uart_req* req, uint16_t* interval)
+{
+    *interval = uart_get_ACK_CONFIG_REQ_interval(req);
+}
+
+void parse_diag_msg (const uart_req* req, uint16_t* counter)
+{
+    *counter = uart_get_DIAG_REQ_counter(req);
+}
+
+void parse_baud_msg (const uart_req* req, uint32_t* baudrate)
+{
+    *baudrate = (uint32_t) uart_get_BAUD_REQ_rate(req) * UART_BAUD_UNIT;
+}
+
+void parse_telemetry_config_msg (const uart_req* req, uint16_t* rate)
+{
+    *rate = uart_get_TELEMETRY_CONFIG_REQ_rate(req);
+}
+
+void parse_heartbeat_config_msg (const uart_req* req, uint16_t* timeout)
+{
+    *timeout = uart_get_HEARTBEAT_CONFIG_REQ_timeout(req);
+}
+
+void parse_sync_msg (const uart_req* req, uint32_t* host_time)
+{
+    *host_time = uart_get_SYNC_REQ_host_time(req);
+}
+
+void parse_telemetry_codec_msg (const uart_req* req, uint16_t* batch)
+{
+    *batch = uart_get_TELEMETRY_CODEC_REQ_batch(req);
 }
 
 void parse_startstop_msg (const uart_req* req, uint8_t* val)
 {
-    *val = req->req_packed.data;
+    *val = uart_get_START_STOP_REQ_val(req);
 }
 
 void parse_steer_msg (const uart_req* req, uint8_t* dir, int16_t* val)
 {
-	*val = req->req_packed.data & 0x0FFF;
-	*dir = (uint8_t)(req->req_packed.data >> 12);
+	*val = uart_get_STEERING_REQ_val(req);
+	*dir = uart_get_STEERING_REQ_dir(req);
 }
 
 void parse_throttle_msg (const uart_req* req, uint8_t* val)
 {
-    *val = req->req_packed.data;
+    *val = uart_get_THROTTLE_REQ_val(req);
 }
 
 void parse_brake_msg (const uart_req* req, uint8_t* val)
 {
-    *val = req->req_packed.data;
+    *val = uart_get_BRAKE_REQ_val(req);
+}
+
+void parse_control_msg (const uart_req* req, uint8_t* steer_dir, int16_t* steer_val, uint8_t* throttle,
+        uint8_t* brake)
+{
+	*steer_val = uart_get_CONTROL_REQ_steer_val(req);
+	*steer_dir = uart_get_CONTROL_REQ_steer_dir(req);
+	*throttle = uart_get_CONTROL_REQ_throttle(req);
+	*brake = uart_get_CONTROL_REQ_brake(req);
 }
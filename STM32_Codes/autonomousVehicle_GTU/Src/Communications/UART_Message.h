@@ -16,19 +16,157 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 /*------------------------------< Includes >----------------------------------*/
 #include <stdint.h>
 /*------------------------------< Defines >-----------------------------------*/
+#if defined(__cplusplus) && !defined(_Static_assert)
+#define _Static_assert static_assert     //Host_Codes/client bu header ı C++ ile kullanır
+#endif
 
 /*------------------------------< Typedefs >----------------------------------*/
 #define UART_REQ_SIZE (3)
 #define UART_REP_SIZE (3)
+#define UART_CONTROL_REQ_SIZE (5)
+#define UART_ACK_REP_SIZE (12)
+#define UART_TELEMETRY_REP_SIZE (26)
+#define UART_SYNC_REQ_SIZE (5)
+#define UART_SYNC_REP_SIZE (13)
+#define UART_TELEMETRY_DELTA_REP_MIN_SIZE (3)     //boyut değişkendir, Telemetry_Codec.h
+#define UART_RECORDER_ENTRY_SIZE (16)
+#define UART_RECORDER_REP_SIZE (3 + UART_RECORDER_ENTRY_SIZE)
+#define UART_ACK_WINDOW (8)     //ACK_REP in kapsadığı son sıra numarası sayısı
+#define UART_BAUD_UNIT (100)     //BAUD_REQ/BAUD_REP deki hız bu birimle gönderilir, 2 Mbaud = 20000
+
+#define CONTROL_THROTTLE_KEEP (0xFF)     //Control mesajında throttle değiştirilmeyecekse
+#define CONTROL_BRAKE_KEEP    (0xFF)     //Control mesajında fren değiştirilmeyecekse
+
+#define CONTROL_REP_STEER_OK    (0x0001)
+#define CONTROL_REP_THROTTLE_OK (0x0002)
+#define CONTROL_REP_BRAKE_OK    (0x0004)
+
+/**
+ * Mesaj şeması. Yeni bir mesaj eklemek için bu tabloya bir satır eklemek yeterlidir;
+ * header enumu, boyut tabloları ve controller daki dispatch tablosu buradan üretilir.
+ *
+ * REQ(isim, header, boyut, handler, sadece_çerçeveli)
+ * REP(isim, header, boyut)
+ *
+ * handler, MainController.c deki main_controller_on_<handler> fonksiyonudur.
+ * TELEMETRY_DELTA_REP in boyutu çerçeveden çerçeveye değişir, tablodaki değer en küçük boyuttur.
+ * */
+#define UART_MESSAGE_TABLE(REQ, REP) \
+	REQ(START_STOP_REQ, 0, UART_REQ_SIZE, startstop, 0) \
+	REQ(STEERING_REQ, 1, UART_REQ_SIZE, steer, 0) \
+	REQ(THROTTLE_REQ, 2, UART_REQ_SIZE, throttle, 0) \
+	REQ(BRAKE_REQ, 3, UART_REQ_SIZE, brake, 0) \
+	REP(GENERIC_REP, 4, UART_REP_SIZE) \
+	REQ(STATE_REQ, 5, UART_REQ_SIZE, state, 0) \
+	REP(STATE_REP, 6, UART_REP_SIZE) \
+	REQ(CONTROL_REQ, 7, UART_CONTROL_REQ_SIZE, control, 1) \
+	REP(CONTROL_REP, 8, UART_REP_SIZE) \
+	REP(ACK_REP, 9, UART_ACK_REP_SIZE) \
+	REQ(ACK_CONFIG_REQ, 10, UART_REQ_SIZE, ack_config, 1) \
+	REQ(DIAG_REQ, 11, UART_REQ_SIZE, diag, 0) \
+	REP(DIAG_REP, 12, UART_REP_SIZE) \
+	REQ(BAUD_REQ, 13, UART_REQ_SIZE, baud, 1) \
+	REP(BAUD_REP, 14, UART_REP_SIZE) \
+	REP(TELEMETRY_REP, 15, UART_TELEMETRY_REP_SIZE) \
+	REQ(TELEMETRY_CONFIG_REQ, 16, UART_REQ_SIZE, telemetry_config, 1) \
+	REQ(RECORDER_DUMP_REQ, 17, UART_REQ_SIZE, recorder_dump, 1) \
+	REP(RECORDER_REP, 18, UART_RECORDER_REP_SIZE) \
+	REQ(HEARTBEAT_CONFIG_REQ, 19, UART_REQ_SIZE, heartbeat_config, 0) \
+	REQ(SYNC_REQ, 20, UART_SYNC_REQ_SIZE, sync, 1) \
+	REP(SYNC_REP, 21, UART_SYNC_REP_SIZE) \
+	REQ(TELEMETRY_CODEC_REQ, 22, UART_REQ_SIZE, telemetry_codec, 1) \
+	REP(TELEMETRY_DELTA_REP, 23, UART_TELEMETRY_DELTA_REP_MIN_SIZE)
+
+/**
+ * Alan şeması. Her satır için uart_get_<mesaj>_<alan>() decoder ı ve uart_set_<mesaj>_<alan>() encoder ı
+ * üretilir. Firmware REQ leri çözer, REP leri kodlar, Host_Codes/client ise tersini yapar.
+ * REP alanları union üyesini tek başına kullanır. REQ alanları bir üyeyi paylaşabildiği için
+ * REQ encoder ları sadece kendi bitlerini değiştirir, request önceden sıfırlanmalıdır.
+ *
+ * FIELD(mesaj, alan, union üyesi, maske, kaydırma)
+ * */
+#define UART_REQ_FIELD_TABLE(FIELD) \
+	FIELD(START_STOP_REQ, val, req_packed.data, 0xFFFF, 0) \
+	FIELD(STEERING_REQ, val, req_packed.data, 0x0FFF, 0) \
+	FIELD(STEERING_REQ, dir, req_packed.data, 0x000F, 12) \
+	FIELD(THROTTLE_REQ, val, req_packed.data, 0xFFFF, 0) \
+	FIELD(BRAKE_REQ, val, req_packed.data, 0xFFFF, 0) \
+	FIELD(CONTROL_REQ, steer_val, control_packed.steer, 0x0FFF, 0) \
+	FIELD(CONTROL_REQ, steer_dir, control_packed.steer, 0x000F, 12) \
+	FIELD(CONTROL_REQ, throttle, control_packed.throttle, 0xFF, 0) \
+	FIELD(CONTROL_REQ, brake, control_packed.brake, 0xFF, 0) \
+	FIELD(ACK_CONFIG_REQ, interval, req_packed.data, 0xFFFF, 0) \
+	FIELD(DIAG_REQ, counter, req_packed.data, 0xFFFF, 0) \
+	FIELD(BAUD_REQ, rate, req_packed.data, 0xFFFF, 0) \
+	FIELD(TELEMETRY_CONFIG_REQ, rate, req_packed.data, 0xFFFF, 0) \
+	FIELD(HEARTBEAT_CONFIG_REQ, timeout, req_packed.data, 0xFFFF, 0) \
+	FIELD(SYNC_REQ, host_time, sync_packed.host_time, 0xFFFFFFFF, 0) \
+	FIELD(TELEMETRY_CODEC_REQ, batch, req_packed.data, 0xFFFF, 0)
+
+#define UART_REP_FIELD_TABLE(FIELD) \
+	FIELD(GENERIC_REP, val, rep_packed.data, 0x0001, 0) \
+	FIELD(STATE_REP, val, rep_packed.data, 0x0003, 0) \
+	FIELD(CONTROL_REP, val, rep_packed.data, CONTROL_REP_STEER_OK | CONTROL_REP_THROTTLE_OK | CONTROL_REP_BRAKE_OK, 0) \
+	FIELD(ACK_REP, seq, ack_packed.seq, 0xFF, 0) \
+	FIELD(ACK_REP, received, ack_packed.received, 0xFF, 0) \
+	FIELD(ACK_REP, results, ack_packed.results, 0xFFFF, 0) \
+	FIELD(ACK_REP, time, ack_packed.time, 0xFFFFFFFF, 0) \
+	FIELD(ACK_REP, rx_queue, ack_packed.rx_queue, 0xFF, 0) \
+	FIELD(ACK_REP, rx_seq, ack_packed.rx_seq, 0xFF, 0) \
+	FIELD(ACK_REP, credits, ack_packed.credits, 0xFF, 0) \
+	FIELD(DIAG_REP, val, rep_packed.data, 0xFFFF, 0) \
+	FIELD(BAUD_REP, rate, rep_packed.data, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, tick, telemetry_packed.tick, 0xFFFFFFFF, 0) \
+	FIELD(TELEMETRY_REP, steer, telemetry_packed.steer, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, throttle, telemetry_packed.throttle, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, brake_current, telemetry_packed.brake_current, 0xFF, 0) \
+	FIELD(TELEMETRY_REP, brake_next, telemetry_packed.brake_next, 0xFF, 0) \
+	FIELD(TELEMETRY_REP, distance, telemetry_packed.distance, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, rx_queue, telemetry_packed.rx_queue, 0xFF, 0) \
+	FIELD(TELEMETRY_REP, tx_queue, telemetry_packed.tx_queue, 0xFF, 0) \
+	FIELD(TELEMETRY_REP, time, telemetry_packed.time, 0xFFFFFFFF, 0) \
+	FIELD(TELEMETRY_REP, steer_target, telemetry_packed.steer_target, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, steer_rate, telemetry_packed.steer_rate, 0xFFFF, 0) \
+	FIELD(TELEMETRY_REP, steer_moving, telemetry_packed.steer_moving, 0xFF, 0) \
+	FIELD(TELEMETRY_REP, expired, telemetry_packed.expired, 0xFFFF, 0) \
+	FIELD(RECORDER_REP, remaining, recorder_packed.remaining, 0xFFFF, 0) \
+	FIELD(SYNC_REP, host_time, sync_packed.host_time, 0xFFFFFFFF, 0) \
+	FIELD(SYNC_REP, rx_time, sync_packed.rx_time, 0xFFFFFFFF, 0) \
+	FIELD(SYNC_REP, tx_time, sync_packed.tx_time, 0xFFFFFFFF, 0)
+
+#define UART_HEADER_ENUM(name, id, ...) name = id,
+#define UART_HEADER_COUNT_ENUM(name, ...) UART_HEADER_INDEX_##name,
 
 enum HEADERS {
-	START_STOP_REQ = 0,
-	STEERING_REQ = 1,
-	THROTTLE_REQ = 2,
-	BRAKE_REQ = 3,
-	GENERIC_REP = 4,
-	STATE_REQ = 5,
-	STATE_REP = 6
+	UART_MESSAGE_TABLE(UART_HEADER_ENUM, UART_HEADER_ENUM)
+};
+
+enum {
+	UART_MESSAGE_TABLE(UART_HEADER_COUNT_ENUM, UART_HEADER_COUNT_ENUM)
+	UART_HEADER_COUNT
+};
+
+enum DIAG_COUNTER {
+	DIAG_EXPIRED_COMMANDS = 0,     //geçerlilik süresi dolduğu için uygulanmayan komutlar
+	DIAG_UART_OVERRUN = 1,
+	DIAG_UART_FRAMING = 2,
+	DIAG_UART_NOISE = 3,
+	DIAG_UART_PARITY = 4,
+	DIAG_CRC_ERRORS = 5,     //CRC si tutmayan çerçeveler
+	DIAG_HEADER_ERRORS = 6,     //geçersiz LEN veya header ile uyuşmayan payload boyutu
+	DIAG_QUEUE_FULL = 7,     //receive tarafındaki queue dolu olduğu için atılan mesajlar
+	DIAG_RX_TIMEOUTS = 8,     //UART_RECEIVE_TIMEOUT boyunca hiç byte gelmedi
+	DIAG_HEARTBEAT_STOPS = 9,     //heartbeat timeout u nedeniyle yapılan kontrollü duruşlar
+	DIAG_HEARTBEAT_LATENCY_MAX = 10,     //us, heartbeat deadline ından ilk aktüatör komutuna kadar en uzun süre
+	DIAG_RX_OVERFLOW = 11,     //DMA receive buffer ı receive threadi okuyamadan doldu, byte lar atıldı
+	DIAG_STOP_LATENCY_MAX = 12     //us, STOP un son byte ının alınmasından emergency_stop( ) un bitişine kadar en uzun süre
+};
+
+enum ACK_RESULT {
+	ACK_ERROR = 0,
+	ACK_OK = 1,
+	ACK_UNKNOWN = 2,     //header tanınmadı
+	ACK_SUPERSEDED = 3   //uygulanmadan önce aynı aktüatör için daha yeni bir komut geldi
 };
 
 struct UART_req {
@@ -38,9 +176,21 @@ struct UART_req_packed {
 	uint8_t header;
 	uint16_t data;
 }__attribute__((packed, aligned(1)));
+struct UART_control_req_packed {
+	uint8_t header;
+	uint16_t steer;
+	uint8_t throttle;
+	uint8_t brake;
+}__attribute__((packed, aligned(1)));
+struct UART_sync_req_packed {
+	uint8_t header;
+	uint32_t host_time;     //hostun gönderme anı, us, SYNC_REP te aynen geri döner
+}__attribute__((packed, aligned(1)));
 union UART_req_un {
 	struct UART_req req;
 	struct UART_req_packed req_packed;
+	struct UART_control_req_packed control_packed;
+	struct UART_sync_req_packed sync_packed;
 };
 
 struct UART_rep {
@@ -50,9 +200,50 @@ struct UART_rep_packed {
 	uint8_t header;
 	uint16_t data;
 }__attribute__((packed, aligned(1)));
+struct UART_ack_rep_packed {
+	uint8_t header;
+	uint8_t seq;          //en son işlenen requestin sıra numarası
+	uint8_t received;     //bit i: seq - i numaralı request işlendi
+	uint16_t results;     //bit 2i..2i+1: seq - i numaralı requestin ACK_RESULT değeri
+	uint32_t time;        //seq numaralı requestin işlendiği MCU zamanı, us
+	uint8_t rx_queue;     //controllerın işlemeyi beklediği request sayısı
+	uint8_t rx_seq;       //receive threadinin en son aldığı requestin sıra numarası
+	uint8_t credits;      //rx_seq ten sonra queue ya sığacak request sayısı
+}__attribute__((packed, aligned(1)));
+struct UART_telemetry_rep_packed {
+	uint8_t header;
+	uint32_t tick;           //snapshotın alındığı tick (ms)
+	int16_t steer;           //steer_state.position
+	uint16_t throttle;       //throttle_get_value()
+	uint8_t brake_current;   //BrakePosition
+	uint8_t brake_next;      //BrakePosition
+	uint16_t distance;       //ultrasonik sensör, cm
+	uint8_t rx_queue;        //controllerın işlemeyi beklediği request sayısı
+	uint8_t tx_queue;        //transmit queue da bekleyen rep sayısı
+	uint32_t time;           //snapshotın alındığı MCU zamanı, us
+	int16_t steer_target;    //steer_state.target
+	int16_t steer_rate;      //steer_state.rate, step/s
+	uint8_t steer_moving;    //steer_state.moving
+	uint16_t expired;        //süresi dolduğu için uygulanmayan komut sayısı, DIAG_EXPIRED_COMMANDS
+}__attribute__((packed, aligned(1)));
+struct UART_recorder_rep_packed {
+	uint8_t header;
+	uint16_t remaining;     //bu kayıttan sonra gönderilecek kayıt sayısı
+	uint8_t entry[UART_RECORDER_ENTRY_SIZE];     //flight_recorder_entry
+}__attribute__((packed, aligned(1)));
+struct UART_sync_rep_packed {
+	uint8_t header;
+	uint32_t host_time;     //SYNC_REQ teki değer
+	uint32_t rx_time;       //SYNC_REQ in son byte ının geldiği MCU zamanı, us
+	uint32_t tx_time;       //SYNC_REP in transmit bufferına yazıldığı MCU zamanı, us
+}__attribute__((packed, aligned(1)));
 union UART_rep_un {
 	struct UART_rep rep;
 	struct UART_rep_packed rep_packed;
+	struct UART_ack_rep_packed ack_packed;
+	struct UART_telemetry_rep_packed telemetry_packed;
+	struct UART_recorder_rep_packed recorder_packed;
+	struct UART_sync_rep_packed sync_packed;
 };
 enum STATE{
     STOPPED = 0,
@@ -64,15 +255,87 @@ enum STATE{
 typedef union UART_req_un uart_req;
 typedef union UART_rep_un uart_rep;
 /*------------------------------< Constants >---------------------------------*/
+_Static_assert(sizeof(struct UART_req_packed) == UART_REQ_SIZE, "UART_REQ_SIZE does not match UART_req_packed");
+_Static_assert(sizeof(struct UART_rep_packed) == UART_REP_SIZE, "UART_REP_SIZE does not match UART_rep_packed");
+_Static_assert(sizeof(struct UART_control_req_packed) == UART_CONTROL_REQ_SIZE,
+        "UART_CONTROL_REQ_SIZE does not match UART_control_req_packed");
+_Static_assert(sizeof(struct UART_ack_rep_packed) == UART_ACK_REP_SIZE,
+        "UART_ACK_REP_SIZE does not match UART_ack_rep_packed");
+_Static_assert(sizeof(struct UART_telemetry_rep_packed) == UART_TELEMETRY_REP_SIZE,
+        "UART_TELEMETRY_REP_SIZE does not match UART_telemetry_rep_packed");
+_Static_assert(sizeof(struct UART_recorder_rep_packed) == UART_RECORDER_REP_SIZE,
+        "UART_RECORDER_REP_SIZE does not match UART_recorder_rep_packed");
+_Static_assert(sizeof(struct UART_sync_req_packed) == UART_SYNC_REQ_SIZE,
+        "UART_SYNC_REQ_SIZE does not match UART_sync_req_packed");
+_Static_assert(sizeof(struct UART_sync_rep_packed) == UART_SYNC_REP_SIZE,
+        "UART_SYNC_REP_SIZE does not match UART_sync_rep_packed");
+
+#define UART_REQ_SIZE_CHECK(name, id, size, ...) \
+	_Static_assert((id) < UART_HEADER_COUNT, #name " header is out of the dispatch table"); \
+	_Static_assert((size) <= sizeof(uart_req), #name " does not fit in uart_req");
+#define UART_REP_SIZE_CHECK(name, id, size) \
+	_Static_assert((id) < UART_HEADER_COUNT, #name " header is out of the dispatch table"); \
+	_Static_assert((size) <= sizeof(uart_rep), #name " does not fit in uart_rep");
+UART_MESSAGE_TABLE(UART_REQ_SIZE_CHECK, UART_REP_SIZE_CHECK)
+#undef UART_REQ_SIZE_CHECK
+#undef UART_REP_SIZE_CHECK
+
+#define UART_REQ_DECODER(msg, field, member, mask, shift) \
+static inline uint32_t uart_get_##msg##_##field (const uart_req* req) \
+{ \
+	return ((uint32_t) req->member >> (shift)) & (mask); \
+}
+#define UART_REP_ENCODER(msg, field, member, mask, shift) \
+static inline void uart_set_##msg##_##field (uart_rep* rep, uint32_t val) \
+{ \
+	rep->rep_packed.header = msg; \
+	rep->member = (val & (mask)) << (shift); \
+}
+#define UART_REQ_ENCODER(msg, field, member, mask, shift) \
+static inline void uart_set_##msg##_##field (uart_req* req, uint32_t val) \
+{ \
+	req->req_packed.header = msg; \
+	req->member = (req->member & ~((uint32_t) (mask) << (shift))) | ((val & (mask)) << (shift)); \
+}
+#define UART_REP_DECODER(msg, field, member, mask, shift) \
+static inline uint32_t uart_get_##msg##_##field (const uart_rep* rep) \
+{ \
+	return ((uint32_t) rep->member >> (shift)) & (mask); \
+}
+UART_REQ_FIELD_TABLE(UART_REQ_DECODER)
+UART_REQ_FIELD_TABLE(UART_REQ_ENCODER)
+UART_REP_FIELD_TABLE(UART_REP_ENCODER)
+UART_REP_FIELD_TABLE(UART_REP_DECODER)
+#undef UART_REQ_DECODER
+#undef UART_REQ_ENCODER
+#undef UART_REP_ENCODER
+#undef UART_REP_DECODER
 
 /*------------------------------< Prototypes >--------------------------------*/
 void create_state_rep_msg(uart_rep* rep, enum STATE val);
 void create_steer_rep_msg(uart_rep* rep, const uint16_t val);
 void create_general_rep_msg(uart_rep* rep, const uint8_t val);
+void create_control_rep_msg(uart_rep* rep, const uint16_t val);
+void create_ack_rep_msg(uart_rep* rep, uint8_t seq, uint8_t received, uint16_t results, uint32_t time,
+        uint8_t rx_queue, uint8_t rx_seq, uint8_t credits);
+void create_sync_rep_msg(uart_rep* rep, uint32_t host_time, uint32_t rx_time);
+void create_diag_rep_msg(uart_rep* rep, const uint16_t val);
+void create_baud_rep_msg(uart_rep* rep, const uint32_t baudrate);
+uint8_t get_req_msg_size(const uart_req* req);
+uint8_t get_rep_msg_size(const uart_rep* rep);
 void parse_steer_msg(const uart_req* req, uint8_t* dir, int16_t* val);
 void parse_throttle_msg(const uart_req* req, uint8_t* val);
 void parse_brake_msg(const uart_req* req, uint8_t* val);
 void parse_startstop_msg(const uart_req* msg, uint8_t* val);
+void parse_ack_config_msg(const uart_req* req, uint16_t* interval);
+void parse_diag_msg(const uart_req* req, uint16_t* counter);
+void parse_baud_msg(const uart_req* req, uint32_t* baudrate);
+void parse_telemetry_config_msg(const uart_req* req, uint16_t* rate);
+void parse_heartbeat_config_msg(const uart_req* req, uint16_t* timeout);
+void parse_sync_msg(const uart_req* req, uint32_t* host_time);
+void parse_telemetry_codec_msg(const uart_req* req, uint16_t* batch);
+void parse_control_msg(const uart_req* req, uint8_t* steer_dir, int16_t* steer_val, uint8_t* throttle,
+        uint8_t* brake);
 #if defined(__cplusplus)
 }                /* Make sure we have C-declarations in C++ programs */
 #endif
@@ -96,6 +96,11 @@ BrakePosition brake_get_value ( )
     return brake_current_position;
 }
 
+BrakePosition brake_get_next_value ( )
+{
+    return brake_next_position;
+}
+
 void brake_set_value (BrakePosition val)
 {
     if (val == brake_next_position || val == brake_current_position)
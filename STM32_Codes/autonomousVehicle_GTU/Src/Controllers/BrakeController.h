@@ -26,6 +26,7 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 
 void brake_init ( );
 BrakePosition brake_get_value ( );
+BrakePosition brake_get_next_value ( );
 void brake_set_value (BrakePosition val);
 float brake_get_rotary_position_sensor_value ( );
 void brake_test ( );
@@ -0,0 +1,182 @@
+/**
+ * \file        HeartbeatSupervisor.c
+ * \brief       Hosttan gelen her geçerli mesaj heartbeat sayılır, ayrı bir heartbeat mesajı gerekmez.
+ *              Son mesajdan sonra timeout süresi dolarsa ve araç çalışıyorsa kontrollü duruş başlatılır:
+ *              yeni setpointler reddedilir, gaz adım adım SPEED_0 a indirilir, ardından THROTTLE_LOCK ve
+ *              BRAKE_LOCK uygulanır. Direksiyon o an gittiği hedefe kadar gider, yeni hedef kabul edilmez.
+ *
+ *              Supervisor threadi her mesajda uyandırılmaz. Son mesajın tick i receive threadinde yazılır,
+ *              thread ise sadece o anki deadline a kadar uyur ve uyandığında deadline ı yeniden hesaplar.
+ *              Sağlıklı bir hatta timeout başına bir kez uyanır. osPriorityRealtime ile çalıştığı için
+ *              hat kopmasının algılanması en fazla deadline + 1 tick gecikir.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+/*------------------------------< Includes >----------------------------------*/
+#include "HeartbeatSupervisor.h"
+#include "main.h"
+#include "cmsis_os.h"
+#include "helpers.h"
+#include "BrakeController.h"
+#include "ThrottleController.h"
+#include "Communications/Communication_Mechanism.h"
+/*------------------------------< Defines >-----------------------------------*/
+
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Variables >---------------------------------*/
+osThreadId heartbeatTaskHandle;
+uint32_t heartbeatTaskBuffer[256];
+osStaticThreadDef_t heartbeatTaskControlBlock;
+
+static StaticSemaphore_t xHeartbeatSemaphoreBuffer;
+static SemaphoreHandle_t xHeartbeatSemaphore;     //timeout değiştiğinde threadi deadline ı yeniden hesaplaması için uyandırır
+
+static volatile uint16_t heartbeat_timeout = HEARTBEAT_DEFAULT_TIMEOUT;     //ms, 0 ise supervisor kapalı
+static volatile uint8_t heartbeat_stopping;
+static volatile uint16_t heartbeat_stop_count;
+static volatile uint32_t heartbeat_latency_max;     //cycle, deadline dan ilk aktüatör komutuna kadar
+/*------------------------------< Prototypes >--------------------------------*/
+void heartbeat_task (void const * argument);
+static void heartbeat_controlled_stop (TickType_t deadline);
+/*------------------------------< Functions >---------------------------------*/
+
+void heartbeat_init ( )
+{
+    xHeartbeatSemaphore = xSemaphoreCreateBinaryStatic(&xHeartbeatSemaphoreBuffer);
+    osThreadStaticDef(HeartbeatTask, heartbeat_task, osPriorityRealtime, 0, 256, heartbeatTaskBuffer,
+            &heartbeatTaskControlBlock);
+    heartbeatTaskHandle = osThreadCreate(osThread(HeartbeatTask), NULL);
+}
+
+/**
+ * Son mesajdan deadline a kadar uyunur. Deadline geçmişse aynı sessizlik için bir kez kontrollü duruş yapılır,
+ * hat kopuk kaldığı sürece timeout periyoduyla bakılır. Bu sırada gelen bir mesajın deadline ı uyanma
+ * anından önce olamaz, bu yüzden algılama gecikmesi bu durumda da artmaz.
+ * */
+void heartbeat_task (void const * argument)
+{
+    TickType_t handled_tick = 0;
+    uint8_t handled = 0;
+
+    while (1)
+    {
+        TickType_t timeout = pdMS_TO_TICKS(heartbeat_timeout);
+        TickType_t last_tick = communication_get_last_rx_tick( );
+        TickType_t elapsed = xTaskGetTickCount( ) - last_tick;
+        TickType_t wait;
+
+        if (timeout == 0)
+        {
+            wait = portMAX_DELAY;
+        }
+        else if (elapsed < timeout)
+        {
+            wait = timeout - elapsed;
+        }
+        else if (handled && last_tick == handled_tick)
+        {
+            wait = timeout;
+        }
+        else
+        {
+            handled = 1;
+            handled_tick = last_tick;
+            if (is_started == 1)
+            {
+                heartbeat_controlled_stop(last_tick + timeout);
+            }
+            continue;
+        }
+        xSemaphoreTake(xHeartbeatSemaphore, wait);
+    }
+}
+
+/**
+ * timeout ms cinsindendir, 0 supervisor ı kapatır. Host sürüş moduna göre (ör. park manevrasında uzun,
+ * yüksek hızda kısa) değiştirebilir. HEARTBEAT_TIMEOUT_MIN ve HEARTBEAT_TIMEOUT_MAX dışındaki değerler reddedilir.
+ * */
+Return_Status heartbeat_set_timeout (uint16_t timeout)
+{
+    if (timeout != 0 && (timeout < HEARTBEAT_TIMEOUT_MIN || timeout > HEARTBEAT_TIMEOUT_MAX))
+    {
+        return NOK;
+    }
+    heartbeat_timeout = timeout;
+    if (xHeartbeatSemaphore != NULL)
+    {
+        xSemaphoreGive(xHeartbeatSemaphore);
+    }
+    return OK;
+}
+
+uint16_t heartbeat_get_timeout ( )
+{
+    return heartbeat_timeout;
+}
+
+/**
+ * Kontrollü duruş sürerken 1 döner, bu sürede START kabul edilmez.
+ * */
+uint8_t heartbeat_is_stopping ( )
+{
+    return heartbeat_stopping;
+}
+
+uint16_t heartbeat_get_stop_count ( )
+{
+    return heartbeat_stop_count;
+}
+
+/**
+ * Heartbeat deadline ından (son mesaj + timeout) ilk aktüatör komutuna (gazın azaltılması veya fren) kadar
+ * geçen en uzun süreyi cycle cinsinden döner. Algılama gecikmesi de bu sürenin içindedir.
+ * */
+uint32_t heartbeat_get_latency_max ( )
+{
+    return heartbeat_latency_max;
+}
+
+/**
+ * is_started önce sıfırlanır, böylece controller yeni setpointleri reddeder. Gaz HEARTBEAT_THROTTLE_RAMP_PERIOD
+ * aralıklarla azaltılır. Bu sırada STOP gelirse (fren zaten kilitleniyor) rampa bırakılır, aksi halde
+ * throttle_set_value gaz kilidini tekrar açardı.
+ * Gecikme bu fonksiyonun başından değil deadline tick inden ölçülür, threadin uyanması da dahil olur.
+ * */
+static void heartbeat_controlled_stop (TickType_t deadline)
+{
+    uint32_t latency;
+    uint32_t value = throttle_get_value( );
+
+    heartbeat_stopping = 1;
+    is_started = 0;
+    ++heartbeat_stop_count;
+
+    if (value > SPEED_0 && brake_get_next_value( ) != BRAKE_LOCK)
+    {
+        value = (value > SPEED_0 + HEARTBEAT_THROTTLE_RAMP_STEP) ? value - HEARTBEAT_THROTTLE_RAMP_STEP : SPEED_0;
+        throttle_set_value(value);
+    }
+    else
+    {
+        emergency_stop( );
+    }
+    latency = tick_get_elapsed_cycles(deadline);
+    if (latency > heartbeat_latency_max)
+    {
+        heartbeat_latency_max = latency;
+    }
+
+    while (value > SPEED_0 && brake_get_next_value( ) != BRAKE_LOCK)
+    {
+        osDelay(HEARTBEAT_THROTTLE_RAMP_PERIOD);
+        value = (value > SPEED_0 + HEARTBEAT_THROTTLE_RAMP_STEP) ? value - HEARTBEAT_THROTTLE_RAMP_STEP : SPEED_0;
+        throttle_set_value(value);
+    }
+    emergency_stop( );
+    heartbeat_stopping = 0;
+}
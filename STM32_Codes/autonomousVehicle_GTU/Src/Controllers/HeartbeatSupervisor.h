@@ -0,0 +1,41 @@
+/**
+ * \file        HeartbeatSupervisor.h
+ * \brief       Detaylı bilgiyi HeartbeatSupervisor.c de bulunmaktadır.
+ *
+ * \author      ahmet.alperen.bulut
+ * \date        Oct 17, 2026
+ */
+
+#ifndef CONTROLLERS_HEARTBEATSUPERVISOR_H_
+#define CONTROLLERS_HEARTBEATSUPERVISOR_H_
+
+#if defined(__cplusplus)
+extern "C" {     /* Make sure we have C-declarations in C++ programs */
+#endif
+
+/*------------------------------< Includes >----------------------------------*/
+#include <stdint.h>
+#include "autonomousVehicle_conf.h"
+/*------------------------------< Defines >-----------------------------------*/
+#define HEARTBEAT_DEFAULT_TIMEOUT (500)     //ms, açılışta kullanılır
+#define HEARTBEAT_TIMEOUT_MIN (20)     //ms
+#define HEARTBEAT_TIMEOUT_MAX (10000)     //ms
+#define HEARTBEAT_THROTTLE_RAMP_STEP (100)     //DAC değeri, her adımda gazın azaltıldığı miktar
+#define HEARTBEAT_THROTTLE_RAMP_PERIOD (10)     //ms, SPEED_25 ten SPEED_0 a ~190 ms
+/*------------------------------< Typedefs >----------------------------------*/
+
+/*------------------------------< Constants >---------------------------------*/
+
+/*------------------------------< Prototypes >--------------------------------*/
+void heartbeat_init ( );
+Return_Status heartbeat_set_timeout (uint16_t timeout);
+uint16_t heartbeat_get_timeout ( );
+uint8_t heartbeat_is_stopping ( );
+uint16_t heartbeat_get_stop_count ( );
+uint32_t heartbeat_get_latency_max ( );
+
+#if defined(__cplusplus)
+}                /* Make sure we have C-declarations in C++ programs */
+#endif
+
+#endif /* CONTROLLERS_HEARTBEATSUPERVISOR_H_ */
@@ -13,191 +13,404 @@
 #include "BrakeController.h"
 #include "ThrottleController.h"
 #include "SteerController.h"
+#include "HeartbeatSupervisor.h"
 #include "Communications/Communication_Mechanism.h"
 #include "Communications/UART_Communication.h"
 #include "Communications/UART_Message.h"
+#include "Communications/Flight_Recorder.h"
+#include "Sensors/hcsr04.h"
 /*------------------------------< Defines >-----------------------------------*/
 
 /*------------------------------< Typedefs >----------------------------------*/
-
-/*------------------------------< Constants >---------------------------------*/
+typedef uint8_t (*main_controller_handler)(const uart_req* req, uart_rep* rep);
 
 /*------------------------------< Variables >---------------------------------*/
 osThreadId mainControllerTaskHandle;
 uint32_t mainControllerTaskBuffer[ 512 ];
 osStaticThreadDef_t mainControllerTaskControlBlock;
+
+static uint16_t expired_count;     //geçerlilik süresi dolduğu için uygulanmayan komut sayısı
 /*------------------------------< Prototypes >--------------------------------*/
 void main_controller_task (void const * argument);
+static uint8_t main_controller_steer (uint8_t dir, int16_t val);
+static uint8_t main_controller_throttle (uint8_t val);
+static uint8_t main_controller_brake (uint8_t val);
+static uint16_t main_controller_get_diag (uint16_t counter);
+static void main_controller_fill_telemetry (uart_rep* rep);
+
+#define MAIN_CONTROLLER_HANDLER_PROTOTYPE(name, id, size, handler, ...) \
+static uint8_t main_controller_on_##handler (const uart_req* req, uart_rep* rep);
+#define MAIN_CONTROLLER_SKIP(...)
+UART_MESSAGE_TABLE(MAIN_CONTROLLER_HANDLER_PROTOTYPE, MAIN_CONTROLLER_SKIP)
+#undef MAIN_CONTROLLER_HANDLER_PROTOTYPE
+/*------------------------------< Constants >---------------------------------*/
+/**
+ * Header ile indekslenen handler tablosu. Çerçevesiz protokolde sadece çerçeveli
+ * mesajların handlerı boş bırakılır ve bu mesajlar tanınmamış sayılır.
+ * */
+#define MAIN_CONTROLLER_HANDLER_ENTRY(name, id, size, handler, framed_only) \
+[name] = ((framed_only) && !UART_FRAMED_PROTOCOL) ? NULL : main_controller_on_##handler,
+static const main_controller_handler handlers[UART_HEADER_COUNT] = {
+        UART_MESSAGE_TABLE(MAIN_CONTROLLER_HANDLER_ENTRY, MAIN_CONTROLLER_SKIP) };
+#undef MAIN_CONTROLLER_HANDLER_ENTRY
+#undef MAIN_CONTROLLER_SKIP
 /*------------------------------< Functions >---------------------------------*/
 
 void main_controller_init ( )
 {
     osThreadStaticDef(mainController, main_controller_task, osPriorityAboveNormal, 0, 512, mainControllerTaskBuffer, &mainControllerTaskControlBlock);
+    flight_recorder_init( );
     mainControllerTaskHandle = osThreadCreate(osThread(mainController), NULL);
+    communication_set_telemetry_source(main_controller_fill_telemetry);
 }
 
 void main_controller_task (void const * argument)
 {
     /* USER CODE BEGIN ControlTask */
     /* Infinite loop */
-    uart_req req;
+    communication_msg msg;
+    uart_req* req = &msg.req;
     uint8_t ret_val = 0;
+    uint32_t cycles;
     for (;;)
     {
         uart_rep rep = { 0 };
+        enum ACK_RESULT result = ACK_ERROR;
 
-        if (communication_get_msg(&req) == OK)
-        {
-            switch (req.req_packed.header)
-            {
-                case START_STOP_REQ:
-                {
-                    uint8_t val = 0;
-
-                    parse_startstop_msg(&req, &val);
-
-                    if (val == 1)
-                    {
-                        if (HAL_GPIO_ReadPin(EMERGENCY_STOP_GPIO_Port, EMERGENCY_STOP_Pin)
-                                == GPIO_PIN_SET)
-                        {
-                            start_system( );
-                            ret_val = 1;
-                        }
-
-                    }
-                    else if (val == 0)
-                    {
-                        emergency_stop( );
-                    }
-
-                    break;
-                }
-                case STEERING_REQ:
-                {
-                    if (is_started == 1)
-                    {
-                        uint8_t dir;
-                        int16_t val;
-                        parse_steer_msg(&req, &dir, &val);
-                        if (dir == 0)
-                        {
-                            val = val * 7;
-                        }
-                        else
-                        {
-                            val = val * 7 * -1;
-                        }
-                        steer_set_value(val);
-                        ret_val = 1;
-                    }
-                    else
-                    {
-                        ret_val = 0;
-                    }
-                    break;
-                }
-                case THROTTLE_REQ://Throttle
-                {
-                    if (is_started == 1)
-                    {
-                        uint8_t val;
-                        parse_throttle_msg(&req, &val);
-                        switch (val)
-                        {
-                            case 0:
-                            {
-                                throttle_set_value(SPEED_0);
-                                break;
-                            }
-                            case 5:
-                            {
-                                throttle_set_value(SPEED_5);
-                                break;
-                            }
-                            case 8:
-                            {
-                                throttle_set_value(SPEED_8);
-                                break;
-                            }
-                            case 10:
-                            {
-                                throttle_set_value(SPEED_10);
-                                break;
-                            }
-                            case 13:
-                            {
-                                throttle_set_value(SPEED_13);
-                                break;
-                            }
-                            case 15:
-                            {
-                                throttle_set_value(SPEED_15);
-                                break;
-                            }
-                            case 20:
-                            {
-                                throttle_set_value(SPEED_20);
-                                break;
-                            }
-                            default:
-                            {
-
-                                throttle_set_value(SPEED_0);
-                                break;
-                            }
-
-                        }
-                        ret_val = 1;
-                    }
-                    else
-                    {
-                        ret_val = 0;
-                    }
-                    break;
-                }
-                case BRAKE_REQ:
-                {
-                    if (is_started == 1)
-                    {
-                        uint8_t val;
-                        parse_brake_msg(&req, &val);
-                        if (val == 0)
-                        {
-                            brake_set_value(BRAKE_RELEASE);
-                        }
-                        else if (val == 1)
-                        {
-                            throttle_set_lock(THROTTLE_LOCK);
-                            brake_set_value(BRAKE_LOCK);
-                        }
-                        ret_val = 1;
-                    }
-                    else
-                    {
-                        ret_val = 0;
-                    }
-                    break;
-                }
-                case STATE_REQ:
-                {
-                    ret_val = is_started;
-                    break;
-                }
-                default:
-                {
-                    //LOGGER
-                    break;
-                }
-            }
-
+        if (communication_get_msg(&msg) != OK)
+        {
+            continue;
+        }
+        ret_val = 0;
+        cycles = cycle_counter_get( );
+        if (communication_is_expired(&msg))
+        {
+            //Eski bir komutu uygulamak hiç uygulamamaktan daha tehlikeli.
+            ++expired_count;
+        }
+        else if (req->req_packed.header < UART_HEADER_COUNT && handlers[req->req_packed.header] != NULL)
+        {
+            ret_val = handlers[req->req_packed.header](req, &rep);
         }
         else
         {
+            //LOGGER
+            result = ACK_UNKNOWN;
+        }
+        cycles = cycle_counter_get( ) - cycles;
+        if (result != ACK_UNKNOWN)
+        {
+            result = (ret_val == 1) ? ACK_OK : ACK_ERROR;
         }
+        flight_recorder_record(&msg, result, cycles);
+#if UART_FRAMED_PROTOCOL
+        communication_ack(msg.seq, result);
+#else
         create_general_rep_msg(&rep, ret_val);
         communication_send_msg(&rep);
+#endif
 
     }
     /* USER CODE END ControlTask */
 }
+
+static uint8_t main_controller_on_startstop (const uart_req* req, uart_rep* rep)
+{
+    uint8_t val = 0;
+
+    parse_startstop_msg(req, &val);
+
+    if (val == 1)
+    {
+        if (heartbeat_is_stopping( ))
+        {
+            return 0;     //kontrollü duruş bitmeden tekrar başlatılmaz
+        }
+        if (HAL_GPIO_ReadPin(EMERGENCY_STOP_GPIO_Port, EMERGENCY_STOP_Pin) == GPIO_PIN_SET)
+        {
+            taskENTER_CRITICAL();     //receive threadindeki STOP freni bıraktıktan sonra is_started ı sıfırlayamaz
+            start_system( );
+            taskEXIT_CRITICAL();
+            return 1;
+        }
+    }
+    else if (val == 0)
+    {
+        emergency_stop( );
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t main_controller_on_steer (const uart_req* req, uart_rep* rep)
+{
+    uint8_t dir;
+    int16_t val;
+    parse_steer_msg(req, &dir, &val);
+    return main_controller_steer(dir, val);
+}
+
+static uint8_t main_controller_on_throttle (const uart_req* req, uart_rep* rep)
+{
+    uint8_t val;
+    parse_throttle_msg(req, &val);
+    return main_controller_throttle(val);
+}
+
+static uint8_t main_controller_on_brake (const uart_req* req, uart_rep* rep)
+{
+    uint8_t val;
+    parse_brake_msg(req, &val);
+    return main_controller_brake(val);
+}
+
+static uint8_t main_controller_on_state (const uart_req* req, uart_rep* rep)
+{
+#if UART_FRAMED_PROTOCOL
+    create_state_rep_msg(rep, is_started == 1 ? RUNNING : STOPPED);
+    communication_send_msg(rep);
+    return 1;
+#else
+    return is_started;
+#endif
+}
+
+static uint8_t main_controller_on_diag (const uart_req* req, uart_rep* rep)
+{
+    uint16_t counter;
+    parse_diag_msg(req, &counter);
+    create_diag_rep_msg(rep, main_controller_get_diag(counter));
+    communication_send_msg(rep);
+    return 1;
+}
+
+static uint8_t main_controller_on_ack_config (const uart_req* req, uart_rep* rep)
+{
+    uint16_t interval;
+    parse_ack_config_msg(req, &interval);
+    communication_set_ack_interval(interval);
+    return 1;
+}
+
+static uint8_t main_controller_on_baud (const uart_req* req, uart_rep* rep)
+{
+    uint32_t baudrate;
+    parse_baud_msg(req, &baudrate);
+    return communication_request_baudrate(baudrate) == OK ? 1 : 0;
+}
+
+static uint8_t main_controller_on_telemetry_config (const uart_req* req, uart_rep* rep)
+{
+    uint16_t rate;
+    parse_telemetry_config_msg(req, &rate);
+    return communication_set_telemetry_rate(rate) == OK ? 1 : 0;
+}
+
+static uint8_t main_controller_on_telemetry_codec (const uart_req* req, uart_rep* rep)
+{
+    uint16_t batch;
+    parse_telemetry_codec_msg(req, &batch);
+    return communication_set_telemetry_batch(batch) == OK ? 1 : 0;
+}
+
+static uint8_t main_controller_on_heartbeat_config (const uart_req* req, uart_rep* rep)
+{
+    uint16_t timeout;
+    parse_heartbeat_config_msg(req, &timeout);
+    return heartbeat_set_timeout(timeout) == OK ? 1 : 0;
+}
+
+/**
+ * SYNC_REP receive threadinde gönderildi, burada sadece ACK verilir.
+ * */
+static uint8_t main_controller_on_sync (const uart_req* req, uart_rep* rep)
+{
+    return 1;
+}
+
+static uint8_t main_controller_on_recorder_dump (const uart_req* req, uart_rep* rep)
+{
+    flight_recorder_start_dump( );
+    return 1;
+}
+
+static uint8_t main_controller_on_control (const uart_req* req, uart_rep* rep)
+{
+    //Direksiyon, gaz ve fren aynı planner döngüsünden gelir ve tek seferde uygulanır.
+    uint8_t steer_dir;
+    int16_t steer_val;
+    uint8_t throttle;
+    uint8_t brake;
+    uint16_t control_result = 0;
+    uint16_t requested = CONTROL_REP_STEER_OK;     //KEEP ile gönderilmeyen bileşenler
+
+    parse_control_msg(req, &steer_dir, &steer_val, &throttle, &brake);
+    //Fren kilitlenecekse gaz uygulanmaz, önce fren işlenir.
+    if (brake != CONTROL_BRAKE_KEEP)
+    {
+        requested |= CONTROL_REP_BRAKE_OK;
+        if (main_controller_brake(brake) == 1)
+        {
+            control_result |= CONTROL_REP_BRAKE_OK;
+        }
+    }
+    if (main_controller_steer(steer_dir, steer_val) == 1)
+    {
+        control_result |= CONTROL_REP_STEER_OK;
+    }
+    if (throttle != CONTROL_THROTTLE_KEEP)
+    {
+        requested |= CONTROL_REP_THROTTLE_OK;
+        if (brake != 1 && main_controller_throttle(throttle) == 1)
+        {
+            control_result |= CONTROL_REP_THROTTLE_OK;
+        }
+    }
+    create_control_rep_msg(rep, control_result);
+    communication_send_msg(rep);
+    //Bir bileşen bile uygulanmadıysa ACK Error dur, hangisinin uygulandığı CONTROL_REP tedir.
+    return ((control_result & requested) == requested) ? 1 : 0;
+}
+
+/**
+ * Aktüatör yazan fonksiyonlar is_started ı yazmayla aynı kritik bölgede kontrol eder. STOP receive threadinde
+ * emergency_stop( ) ile uygulanır. Kontrol ile yazma arasına girebilseydi controller STOP tan sonra gazı
+ * tekrar açardı.
+ * */
+static uint8_t main_controller_steer (uint8_t dir, int16_t val)
+{
+    uint8_t ret_val = 0;
+
+    if (dir == 0)
+    {
+        val = val * 7;
+    }
+    else
+    {
+        val = val * 7 * -1;
+    }
+    taskENTER_CRITICAL();
+    if (is_started == 1)
+    {
+        steer_set_value(val);
+        ret_val = 1;
+    }
+    taskEXIT_CRITICAL();
+    return ret_val;
+}
+
+static uint8_t main_controller_throttle (uint8_t val)
+{
+    uint32_t value;
+    uint8_t ret_val = 0;
+
+    switch (val)
+    {
+        case 0:
+        {
+            value = SPEED_0;
+            break;
+        }
+        case 5:
+        {
+            value = SPEED_5;
+            break;
+        }
+        case 8:
+        {
+            value = SPEED_8;
+            break;
+        }
+        case 10:
+        {
+            value = SPEED_10;
+            break;
+        }
+        case 13:
+        {
+            value = SPEED_13;
+            break;
+        }
+        case 15:
+        {
+            value = SPEED_15;
+            break;
+        }
+        case 20:
+        {
+            value = SPEED_20;
+            break;
+        }
+        default:
+        {
+
+            value = SPEED_0;
+            break;
+        }
+
+    }
+    taskENTER_CRITICAL();
+    if (is_started == 1)
+    {
+        throttle_set_value(value);
+        ret_val = 1;
+    }
+    taskEXIT_CRITICAL();
+    return ret_val;
+}
+
+static uint8_t main_controller_brake (uint8_t val)
+{
+    uint8_t ret_val = 0;
+
+    taskENTER_CRITICAL();
+    if (is_started == 1)
+    {
+        if (val == 0)
+        {
+            brake_set_value(BRAKE_RELEASE);
+        }
+        else if (val == 1)
+        {
+            throttle_set_lock(THROTTLE_LOCK);
+            brake_set_value(BRAKE_LOCK);
+        }
+        ret_val = 1;
+    }
+    taskEXIT_CRITICAL();
+    return ret_val;
+}
+
+static uint16_t main_controller_get_diag (uint16_t counter)
+{
+    switch (counter)
+    {
+        case DIAG_EXPIRED_COMMANDS:
+            return expired_count;
+        case DIAG_HEARTBEAT_STOPS:
+            return heartbeat_get_stop_count( );
+        case DIAG_HEARTBEAT_LATENCY_MAX:
+        {
+            uint32_t latency = heartbeat_get_latency_max( ) / (SystemCoreClock / 1000000);
+            return (latency > 0xFFFF) ? 0xFFFF : latency;
+        }
+        default:
+            return communication_get_diag(counter);
+    }
+}
+
+static void main_controller_fill_telemetry (uart_rep* rep)
+{
+    steer_state steer;
+
+    steer_get_state(&steer);
+    uart_set_TELEMETRY_REP_steer(rep, (uint16_t) steer.position);
+    uart_set_TELEMETRY_REP_steer_target(rep, (uint16_t) steer.target);
+    uart_set_TELEMETRY_REP_steer_rate(rep, (uint16_t) steer.rate);
+    uart_set_TELEMETRY_REP_steer_moving(rep, steer.moving);
+    uart_set_TELEMETRY_REP_throttle(rep, throttle_get_value( ));
+    uart_set_TELEMETRY_REP_brake_current(rep, brake_get_value( ));
+    uart_set_TELEMETRY_REP_brake_next(rep, brake_get_next_value( ));
+    uart_set_TELEMETRY_REP_distance(rep, hcsr04_get_distance( ));
+    uart_set_TELEMETRY_REP_expired(rep, expired_count);
+}
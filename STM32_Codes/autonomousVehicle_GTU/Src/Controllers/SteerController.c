@@ -5,7 +5,32 @@
  *              Bu motor sürücü pwm ile çalışmaktadır. PWM i üretebilmek için bir thread le high low seklinde ilerlemek cok ilkelce olacağı için
  *              STM32 nin pwm üreticisini kullandık.
  *              Bu PWM i bi yerde durdurmak gerekiyor. Gerekli adım atıldığında durması gerek bunun içinde ikinci bir timer kullanıldı.
- *              Bu timerla aslında pwmin kaç adım attığı tutuluyor bu timerin süresi dolduğunda pwm durduruluyor.
+ *              TIM3, TIM2 nin her update inde (her step pulse unun sonunda) bir sayar, yani atılan adımları sayar.
+ *              TIM3 ün OC1REF i (PWM1, CNT < CCR1 iken high) TRGO olarak TIM2 yi kapılar (gated slave, ITR2).
+ *              Sayaç hareketin adım sayısına ulaştığı anda TIM2 donar, yeni periyodun low yarısında kaldığı için
+ *              fazladan pulse çıkamaz. Adım sayısı yazılımdan bağımsız olarak donanımda tutulur, CC1 kesmesi
+ *              sadece hareketi bitirir veya sıradaki hareketi başlatır, gecikmesi adım kaybettirmez.
+ *              Motor sabit hızla başlatılmaz. Her adımın periyodu bir öncekinden hesaplanır ve trapez bir hız profili
+ *              izlenir: STEERING_START_RATE ten STEERING_ACCELERATION ile STEERING_MAX_RATE e çıkılır, hedefe
+ *              kalan adımlar durmaya ancak yettiğinde aynı ivmeyle START_RATE e inilir. Kısa hareketlerde seyir
+ *              hızına ulaşılmadan yavaşlanır.
+ *              Periyotlar TIM2 nin update kesmesinde yazılır. ARR ve CCR3 preload lu olduğu için yazılan değer
+ *              bir sonraki adımda geçerli olur, kesme gecikmesi pulse ları kaydırmaz. PWM2 modunda her periyodun
+ *              ilk yarısı low, ikinci yarısı high dır, pulse periyodun sonunda biter.
+ *              Hareket sürerken gelen yeni değer timerlar durdurulmadan hareketle birleştirilir. Atılan adımlar
+ *              TIM3 ün sayacından okunur, position sadece hareketin başladığı konumu tutar. Hedef aynı yönde ve
+ *              mevcut hızla durulabilecek kadar uzaktaysa sadece hareketin adım sayısı değişir. Değilse en kısa
+ *              yoldan START_RATE e yavaşlanır, CC1 kesmesinde yön çevrilip kalan yol yeni bir hareket olarak
+ *              atılır. START_RATE motorun ivmelenmeden durup kalkabildiği hız olduğu için yön orada değişir.
+ *              Yön değişince motor durduktan sonra bir START_RATE periyodu pulse suz beklenir (dwell), sonra
+ *              yeni yöndeki ilk adım atılır. Dwell TIM2 nin pulse suz bir periyodudur, TIM3 onu da sayar.
+ *              DIR her zaman TIM2 dururken veya donmuşken, bir periyodun low yarısının başında yazılır. Pulse o
+ *              periyodun ortasında yükselir, yani sürücünün istediği DIR setup süresini timer bekler.
+ *              steer_set_value bloklamaz, kısa bir kritik bölgede registerlara yazıp döner.
+ *              Konum, hız ve hedef steer_get_state ile kilitsiz okunur. Birden fazla alanı değiştiren yazıcılar
+ *              (steer_set_value ve CC1 kesmesi) version ı başta ve sonda bir artırır. Okuyucu version tekken veya
+ *              okuma sırasında değiştiyse tekrar okur. Yazıcılar kesme veya kritik bölge içinde olduğu için
+ *              okuyucu hiçbir zaman beklemez, en fazla bir kez daha okur.
  *
  *  Detaylı bilgi için Ahmet Alperen BULUT https://www.linkedin.com/in/ahmetalperenbulut
  * \author      ahmet.alperen.bulut
@@ -19,60 +44,319 @@
 #include "main.h"
 #include <stdlib.h>
 /*------------------------------< Defines >-----------------------------------*/
-
+#define STEER_TIMER_CLOCK (84000000.0f)     //Hz, TIM2 nin sayma frekansı, prescaler 0
+#define STEER_RATE_SQ(rate) ((float) (rate) * (float) (rate))
+#define STEER_DWELL_PERIOD ((uint32_t) (STEER_TIMER_CLOCK / STEERING_START_RATE))     //TIM2 clock, yön değişiminde beklenen süre
+#define STEER_NO_PULSE (0xFFFFFFFFUL)     //CCR3 > ARR, PWM2 periyot boyunca low kalır
 /*------------------------------< Typedefs >----------------------------------*/
-
+struct STEER_MOTION
+{
+    uint32_t version;     //tek ise yazıcı alanları değiştiriyor
+    uint8_t active;     //timerlar çalışıyor
+    int8_t direction;     //1 veya -1, position a göre
+    int32_t target;     //en son istenen değer
+    uint32_t steps;     //hareketin toplam adım sayısı, TIM3->CCR1 = steps + skip
+    uint8_t skip;     //TIM3 ün saydığı ama adım olmayan periyot sayısı, dwell varsa 1
+    uint32_t scheduled;     //periyodu TIM2 ye yazılmış adım sayısı
+    float rate;     //en son yazılan adımın hızı, step/s
+    float rate_sq;
+};
 /*------------------------------< Constants >---------------------------------*/
+//DIR dwell in başında yazılır, dwell ve ilk adımın low yarısı setup süresini karşılamalı
+_Static_assert(STEERING_DIR_SETUP_TIME * STEERING_START_RATE < 1000000UL,
+        "the STEERING_START_RATE dwell is shorter than STEERING_DIR_SETUP_TIME");
 
 /*------------------------------< Variables >---------------------------------*/
-int32_t position;
+volatile int32_t position;     //hareket sürüyorsa hareketin başladığı konum, sürmüyorsa motorun konumu
+static volatile struct STEER_MOTION motion;     //steer_set_value, TIM2/TIM3 kesmeleri ve okuyucular arasında paylaşılır
 /*------------------------------< Prototypes >--------------------------------*/
-
+static void steer_start_motion ( );
+static void steer_retarget ( );
+static void steer_set_direction (int32_t distance);
+static uint32_t steer_stop_steps ( );
+static void steer_schedule_step ( );
+static void steer_schedule_dwell ( );
+static void steer_stop_timers ( );
 /*------------------------------< Functions >---------------------------------*/
 
 void steer_init ( )
 {
     position = 0;
-
+    motion.active = 0;
+    motion.target = 0;
+    motion.steps = 0;
+    motion.scheduled = 0;
     //call configure
 }
 
 void steer_set_value (int val)
 {
-    if (val < STEERING_MIN_VALUE || val > STEERING_MAX_VALUE || position == val)
+    if (val < STEERING_MIN_VALUE || val > STEERING_MAX_VALUE)
     {
         return;
     }
-    HAL_TIM_PWM_Stop(&htim2, TIM_CHANNEL_3);
-    HAL_TIM_Base_Stop(&htim3);     //check it
-    HAL_GPIO_WritePin(STEER_PWM_GPIO_Port, STEER_PWM_Pin, GPIO_PIN_RESET);
+    taskENTER_CRITICAL();     //TIM2/TIM3 kesmeleri motion ı değiştirmesin
+    if (motion.target != val)
+    {
+        ++motion.version;
+        motion.target = val;
+        if (!motion.active)
+        {
+            steer_start_motion( );
+        }
+        else if ((TIM3->SR & TIM_SR_CC1IF) == 0)
+        {
+            steer_retarget( );
+        }
+        //CC1 bekliyorsa hareket bitmiştir, kesme yeni hedefe devam eder
+        ++motion.version;
+    }
+    taskEXIT_CRITICAL();
+}
+
+int steer_get_value ( )
+{
+    steer_state state;
+
+    steer_get_state(&state);
+    return state.position;
+}
+
+/**
+ * Herhangi bir task tan kritik bölgeye girmeden çağrılabilir. Hareket sürüyorsa konum TIM3 ün saydığı
+ * adımlardan hesaplanır (dwell sayılmaz), hız TIM2 ye en son yazılan adımın hızıdır.
+ * */
+void steer_get_state (steer_state* state)
+{
+    uint32_t version;
+
+    do
+    {
+        version = motion.version;
+        state->position = position;
+        state->target = motion.target;
+        state->rate = 0;
+        state->moving = motion.active;
+        if (state->moving)
+        {
+            uint32_t count = TIM3->CNT;
+
+            state->position += motion.direction * (int32_t) ((count > motion.skip) ? count - motion.skip : 0);
+            state->rate = motion.direction * (int32_t) motion.rate;
+        }
+    }
+    while ((version & 1) || version != motion.version);
+}
+
+/**
+ * TIM2 update kesmesi, stm32f4xx_it.c den çağrılır. Bir adım bitti, preload taki adım başladı.
+ * Ondan sonraki adımın periyodu yazılır.
+ * */
+void steer_step_irq_handler ( )
+{
+    if ((TIM2->SR & TIM_SR_UIF) == 0)
+    {
+        return;
+    }
+    TIM2->SR = ~TIM_SR_UIF;
+    if (motion.active && motion.scheduled < motion.steps)
+    {
+        steer_schedule_step( );
+    }
+}
+
+/**
+ * TIM3 CC1 kesmesi, stm32f4xx_it.c den çağrılır. TIM3 hareketin son adımını saydı ve TIM2 yi yeni bir
+ * periyodun low yarısında dondurdu. Hedefe varıldıysa timerlar kapatılır. Varılmadıysa DIR donmuşken yazılır,
+ * TIM3 sıfırlanınca kapı açılır. Yön aynıysa donan periyot yeni hareketin ilk adımı olur, periyodu son
+ * adımınkidir, yani START_RATE tir. Yön değiştiyse donan periyot UG ile dwell e çevrilir, ilk adım ondan sonra
+ * atılır. UG TRGO dan TIM3 e de sayılır, TIM3 ondan sonra sıfırlanır.
+ * */
+void steer_count_irq_handler ( )
+{
+    if ((TIM3->SR & TIM_SR_CC1IF) == 0)
+    {
+        return;
+    }
+    TIM3->SR = ~TIM_SR_CC1IF;
+    if (!motion.active || TIM3->CNT != motion.steps + motion.skip)
+    {
+        return;     //CC1 bayrağı kalkarken hareket uzatıldı
+    }
+    ++motion.version;
+    position += motion.direction * (int32_t) motion.steps;
+    if (position == motion.target)
+    {
+        steer_stop_timers( );
+    }
+    else
+    {
+        int8_t direction = motion.direction;
+
+        steer_set_direction(motion.target - position);
+        motion.skip = (motion.direction != direction);
+        motion.scheduled = !motion.skip;     //yön aynıysa donan periyot ilk adımdır
+        if (motion.skip)
+        {
+            steer_schedule_dwell( );
+            HAL_TIM_GenerateEvent(&htim2, TIM_EVENTSOURCE_UPDATE);
+            TIM2->SR = ~TIM_SR_UIF;
+            motion.rate = 0;
+            motion.rate_sq = 0;
+        }
+        TIM3->CCR1 = motion.steps + motion.skip;
+        TIM3->CNT = 0;     //TIM2 nin kapısı açılır
+        if (motion.scheduled < motion.steps)
+        {
+            steer_schedule_step( );
+        }
+    }
+    ++motion.version;
+}
+
+/**
+ * Motor duruyorken çağrılır, ilk iki periyot yazılıp timerlar başlatılır. TIM2 CNT = 0 dan başlar,
+ * ilk pulse START_RATE periyodunun yarısında yükselir, DIR setup süresi için beklemeye gerek yoktur.
+ * Yön son hareketinkinden farklıysa motor az önce durmuş olabilir, ilk periyot dwell olur.
+ * */
+static void steer_start_motion ( )
+{
+    int8_t direction = motion.direction;
+
+    steer_set_direction(motion.target - position);
+    motion.skip = (motion.direction != direction);
+    motion.scheduled = 0;
+    motion.rate = 0;
+    motion.rate_sq = 0;
+
+    TIM2->CNT = 0;
+    if (motion.skip)
+    {
+        steer_schedule_dwell( );
+    }
+    else
+    {
+        steer_schedule_step( );
+    }
+    HAL_TIM_GenerateEvent(&htim2, TIM_EVENTSOURCE_UPDATE);     //ilk periyot preload dan yüklenir, TIM3 kapalı olduğu için sayılmaz
+    TIM2->SR = ~TIM_SR_UIF;
+    if (motion.scheduled < motion.steps)
+    {
+        steer_schedule_step( );
+    }
     TIM3->CNT = 0;
-    if (position > val)
+    TIM3->CCR1 = motion.steps + motion.skip;
+    TIM3->SR = ~TIM_SR_CC1IF;
+    TIM3->DIER |= TIM_DIER_CC1IE;
+    TIM3->CR1 |= TIM_CR1_CEN;
+
+    motion.active = 1;
+    TIM2->DIER |= TIM_DIER_UIE;
+    HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_3);
+}
+
+/**
+ * Hareket sürerken çağrılır. Periyodu yazılmış adımlar geri alınamaz, onlardan sonra mevcut hızdan
+ * START_RATE e inmek için steer_stop_steps kadar adım gerekir. Hedef bundan yakınsa veya ters yöndeyse
+ * orada durulur, gerisini CC1 kesmesi atar.
+ * TIM2 update i ile kesmesi arasında preload tazelenmemiş olabilir. UIF kalkmışsa kesme yazacaktır,
+ * kalkmamışsa ve preload ta yeni bir adım yoksa burada yazılır.
+ * */
+static void steer_retarget ( )
+{
+    int32_t distance = (motion.target - position) * motion.direction;
+    uint32_t min_steps = motion.scheduled + steer_stop_steps( );
+
+    motion.steps = (distance > 0 && (uint32_t) distance >= min_steps) ? (uint32_t) distance : min_steps;
+    TIM3->CCR1 = motion.steps + motion.skip;
+    if ((TIM2->SR & TIM_SR_UIF) == 0 && motion.scheduled + motion.skip <= TIM3->CNT + 1
+            && motion.scheduled < motion.steps)
+    {
+        steer_schedule_step( );
+    }
+}
+
+/**
+ * distance ın yönüne göre DIR pini yazılır, hareketin adım sayısı distance ın mutlak değeridir.
+ * */
+static void steer_set_direction (int32_t distance)
+{
+    if (distance < 0)
     {
         HAL_GPIO_WritePin(STEER_DIR_GPIO_Port, STEER_DIR_Pin, GPIO_PIN_SET);
+        motion.direction = -1;
     }
     else
     {
         HAL_GPIO_WritePin(STEER_DIR_GPIO_Port, STEER_DIR_Pin, GPIO_PIN_RESET);
+        motion.direction = 1;
     }
-    int i = 0;
-    while (i < 750)//for delay
+    motion.steps = abs(distance);
+}
+
+/**
+ * Son yazılan adımın hızından START_RATE e inmek için gereken adım sayısı, (v^2 - v0^2) / 2a.
+ * */
+static uint32_t steer_stop_steps ( )
+{
+    float excess = motion.rate_sq - STEER_RATE_SQ(STEERING_START_RATE);
+
+    return (excess > 0) ? (uint32_t) (excess / (2.0f * STEERING_ACCELERATION)) + 1 : 0;
+}
+
+/**
+ * Sıradaki adımın hızı üç sınırın en küçüğüdür: önceki adımdan bir adımlık ivmelenme (v^2 + 2a),
+ * seyir hızı ve kalan adımlarda START_RATE e inebilmek için izin verilen en yüksek hız.
+ * Karekök yerine önceki hızdan bir Newton adımı kullanılır, adımlar arası değişim küçük olduğu için yeterlidir.
+ * */
+static void steer_schedule_step ( )
+{
+    uint32_t remaining = motion.steps - motion.scheduled - 1;     //bu adımdan sonra kalan
+    float rate_sq = motion.rate_sq + 2.0f * STEERING_ACCELERATION;
+    float stop_sq = STEER_RATE_SQ(STEERING_START_RATE) + 2.0f * STEERING_ACCELERATION * remaining;
+    uint32_t period;
+
+    if (rate_sq > STEER_RATE_SQ(STEERING_MAX_RATE))
     {
-        ++i;
+        rate_sq = STEER_RATE_SQ(STEERING_MAX_RATE);
     }
-    uint32_t abs_val = abs(position - val);
-    TIM3->CNT = 0;
-    TIM3->ARR = 2 * abs_val - 1;
-    position = val;
+    if (rate_sq > stop_sq)
+    {
+        rate_sq = stop_sq;
+    }
+    if (rate_sq <= STEER_RATE_SQ(STEERING_START_RATE))
+    {
+        rate_sq = STEER_RATE_SQ(STEERING_START_RATE);
+        motion.rate = STEERING_START_RATE;
+    }
+    else
+    {
+        motion.rate = 0.5f * (motion.rate + rate_sq / motion.rate);
+    }
+    motion.rate_sq = rate_sq;
+    period = (uint32_t) (STEER_TIMER_CLOCK / motion.rate);
+    TIM2->ARR = period - 1;
+    TIM2->CCR3 = period / 2;
+    ++motion.scheduled;
+}
 
-    HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_3);
-    HAL_TIM_Base_Start_IT(&htim3);
-    //enable pwm and timer
+/**
+ * Dwell periyodu preload a yazılır: bir START_RATE periyodu, CCR3 ARR den büyük olduğu için pulse çıkmaz.
+ * Adım sayılmaz, motion.scheduled değişmez.
+ * */
+static void steer_schedule_dwell ( )
+{
+    TIM2->ARR = STEER_DWELL_PERIOD - 1;
+    TIM2->CCR3 = STEER_NO_PULSE;
 }
 
-int steer_get_value ( )
+static void steer_stop_timers ( )
 {
-    return position;
+    motion.active = 0;
+    HAL_TIM_PWM_Stop(&htim2, TIM_CHANNEL_3);
+    TIM2->DIER &= ~TIM_DIER_UIE;
+    TIM3->CR1 &= ~TIM_CR1_CEN;
+    TIM3->DIER &= ~TIM_DIER_CC1IE;
 }
 
 void steer_test ( )
@@ -18,6 +18,15 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 /*------------------------------< Defines >-----------------------------------*/
 
 /*------------------------------< Typedefs >----------------------------------*/
+struct STEER_STATE
+{
+    int32_t position;     //motorun şu anki konumu, atılan adımlar dahil
+    int32_t target;     //en son istenen değer
+    int32_t rate;     //step/s, işaret yönü gösterir, duruyorsa 0
+    uint8_t moving;     //0 ise motor hedefte durdu
+};
+
+typedef struct STEER_STATE steer_state;
 
 /*------------------------------< Constants >---------------------------------*/
 
@@ -26,7 +35,10 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 void steer_init ( );
 void steer_set_value (int val);
 int steer_get_value ( );
+void steer_get_state (steer_state* state);
 void steer_test ( );
+void steer_step_irq_handler ( );
+void steer_count_irq_handler ( );
 
 #if defined(__cplusplus)
 }                /* Make sure we have C-declarations in C++ programs */
@@ -26,6 +26,11 @@ uint8_t DWT_Compare(int32_t tp);
 void DWT_Delay(uint32_t us) ;
 /*------------------------------< Functions >---------------------------------*/
 
+uint16_t hcsr04_get_distance ( )
+{
+    return distance;
+}
+
 uint32_t hcsr04_read ( )
 {
     /*local_time = 0;
@@ -24,6 +24,7 @@ extern "C" {     /* Make sure we have C-declarations in C++ programs */
 /*------------------------------< Prototypes >--------------------------------*/
 uint32_t hcsr04_read ( );
 void hcsr04 ( );
+uint16_t hcsr04_get_distance ( );
 
 #if defined(__cplusplus)
 }                /* Make sure we have C-declarations in C++ programs */
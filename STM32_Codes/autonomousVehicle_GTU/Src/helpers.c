@@ -1,4 +1,5 @@
 #include "helpers.h"
+#include "cmsis_os.h"
 
 #include "Controllers/BrakeController.h"
 #include "Controllers/ThrottleController.h"
@@ -35,12 +36,16 @@ void set_orange_led (GPIO_PinState PinState)
     HAL_GPIO_WritePin(LD3_GPIO_Port, LD3_Pin, PinState);
 }
 
+/**
+ * is_started önce sıfırlanır. Controller aktüatörleri is_started ı kontrol ettiği kritik bölgede yazar,
+ * bu fonksiyon bittikten sonra yeni bir setpoint uygulayamaz.
+ * */
 void emergency_stop ( )
 {
+    is_started = 0;
     throttle_set_value(SPEED_0);
     throttle_set_lock(THROTTLE_LOCK);
     brake_set_value(BRAKE_LOCK);
-    is_started = 0;
     set_red_led(GPIO_PIN_SET);
     set_green_led(GPIO_PIN_RESET);
 }
@@ -55,3 +60,73 @@ void start_system ( )
         set_green_led(GPIO_PIN_SET);
     }
 }
+
+/**
+ * DWT cycle counter ı başlatır. Her cycle 1/SystemCoreClock saniyedir (168 MHz de ~6 ns).
+ * */
+void cycle_counter_init ( )
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t cycle_counter_get ( )
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * Son ~25 s içinde alınmış bir CYCCNT değerini açılıştan beri geçen 64 bitlik cycle sayısına çevirir.
+ * CYCCNT 168 MHz de ~25.6 s de bir taşar. Tick sayacı aynı saatten türediği için taşma sayısı tick ten
+ * bulunur, ayrıca taşma sayacı tutulmaz. cycle_counter_init ile scheduler ın başlaması arasındaki fark
+ * 2^31 cycle dan küçük olduğu sürece sonuç tamdır. Kesme içinden çağrılmamalıdır.
+ * */
+uint64_t cycle_counter_extend (uint32_t cycles)
+{
+    uint64_t estimate = (uint64_t) xTaskGetTickCount( ) * (SystemCoreClock / configTICK_RATE_HZ);
+    uint64_t now = estimate + (int32_t) (DWT->CYCCNT - (uint32_t) estimate);
+
+    return now - (uint32_t) ((uint32_t) now - cycles);
+}
+
+/**
+ * Açılıştan beri geçen süre, us. 32 bit olduğu için ~71.6 dakikada bir başa döner.
+ * Telemetri, ACK ve saat senkronizasyonu mesajlarındaki MCU zamanı budur.
+ * */
+uint32_t cycle_counter_get_us ( )
+{
+    return cycle_counter_to_us(DWT->CYCCNT);
+}
+
+uint32_t cycle_counter_to_us (uint32_t cycles)
+{
+    return (uint32_t) (cycle_counter_extend(cycles) / (SystemCoreClock / 1000000));
+}
+
+/**
+ * Tick sayacının tick değerine ulaştığı SysTick kesmesinden şu ana kadar geçen cycle sayısı.
+ * DWT tick ile aynı anda başlamadığı için tick DWT ye çevrilemez, tick içindeki konum SysTick ten okunur.
+ * SysTick taşmış ama kesmesi henüz çalışmamışsa tick sayacı bir geridedir, bu durumda VAL tekrar okunur.
+ * tick henüz gelmediyse 0 döner.
+ * */
+uint32_t tick_get_elapsed_cycles (uint32_t tick)
+{
+    int32_t ticks;
+    uint32_t cycles;
+
+    taskENTER_CRITICAL();
+    ticks = (int32_t) (xTaskGetTickCount( ) - tick);
+    cycles = SysTick->LOAD - SysTick->VAL;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        ++ticks;
+        cycles = SysTick->LOAD - SysTick->VAL;
+    }
+    taskEXIT_CRITICAL();
+    if (ticks < 0)
+    {
+        return 0;
+    }
+    return (uint32_t) ticks * (SysTick->LOAD + 1) + cycles;
+}
@@ -28,6 +28,7 @@
 #include "Controllers/ThrottleController.h"
 #include "Controllers/SteerController.h"
 #include "Controllers/MainController.h"
+#include "Controllers/HeartbeatSupervisor.h"
 #include "Communications/Communication_Mechanism.h"
 #include "Communications/UART_Communication.h"
 #include "Communications/UART_Message.h"
@@ -61,6 +62,8 @@ TIM_HandleTypeDef htim4;
 TIM_HandleTypeDef htim7;
 
 UART_HandleTypeDef huart2;
+DMA_HandleTypeDef hdma_usart2_rx;
+DMA_HandleTypeDef hdma_usart2_tx;
 
 osThreadId defaultTaskHandle;
 uint32_t defaultTaskBuffer[512];
@@ -74,6 +77,7 @@ volatile void (*it_callback_2) ( ) = NULL;
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config (void);
 static void MX_GPIO_Init (void);
+static void MX_DMA_Init (void);
 static void MX_DAC_Init (void);
 static void MX_TIM2_Init (void);
 static void MX_TIM3_Init (void);
@@ -119,6 +123,7 @@ int main (void)
 
     /* Initialize all configured peripherals */
     MX_GPIO_Init( );
+    MX_DMA_Init( );
     MX_DAC_Init( );
     MX_TIM2_Init( );
     MX_TIM3_Init( );
@@ -127,8 +132,6 @@ int main (void)
     MX_TIM7_Init( );
     /* USER CODE BEGIN 2 */
     HAL_DAC_Start(&hdac, DAC_CHANNEL_2);//for throttle
-    HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_3);//
-    HAL_TIM_Base_Start_IT(&htim3);
     HAL_TIM_Base_Start_IT(&htim4);
     HAL_TIM_Base_Start_IT(&htim7);
 
@@ -162,10 +165,10 @@ int main (void)
     brake_init( );
     throttle_set_value(SPEED_0);
     throttle_set_lock(THROTTLE_LOCK);
-    uart_init( );
     steer_init( );
-    communication_init( );
+    communication_init(&uart_transport);
     main_controller_init();
+    heartbeat_init( );
     /* USER CODE END RTOS_THREADS */
 
     /* Start scheduler */
@@ -278,19 +281,21 @@ static void MX_TIM2_Init (void)
     /* USER CODE END TIM2_Init 0 */
 
     TIM_ClockConfigTypeDef sClockSourceConfig = { 0 };
+    TIM_SlaveConfigTypeDef sSlaveConfig = { 0 };
     TIM_MasterConfigTypeDef sMasterConfig = { 0 };
     TIM_OC_InitTypeDef sConfigOC = { 0 };
 
     /* USER CODE BEGIN TIM2_Init 1 */
-    //Prescaler 207 4KHz
-    //Prescaler 332 2.5kHz
+    //Prescaler 0 84 MHz, step periyodu SteerController her adımda ARR ye yazar
+    //Period 20999 4 kHz (STEERING_START_RATE)
+    //Gated slave, ITR2 (TIM3 TRGO) low olduğunda sayaç durur
     /* USER CODE END TIM2_Init 1 */
     htim2.Instance = TIM2;
-    htim2.Init.Prescaler = 207;
+    htim2.Init.Prescaler = 0;
     htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
-    htim2.Init.Period = 100;
+    htim2.Init.Period = 20999;
     htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
     if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
     {
         Error_Handler( );
@@ -304,14 +309,20 @@ static void MX_TIM2_Init (void)
     {
         Error_Handler( );
     }
-    sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    sSlaveConfig.SlaveMode = TIM_SLAVEMODE_GATED;
+    sSlaveConfig.InputTrigger = TIM_TS_ITR2;
+    if (HAL_TIM_SlaveConfigSynchro(&htim2, &sSlaveConfig) != HAL_OK)
+    {
+        Error_Handler( );
+    }
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
     sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
     if (HAL_TIMEx_MasterConfigSynchronization(&htim2, &sMasterConfig) != HAL_OK)
     {
         Error_Handler( );
     }
-    sConfigOC.OCMode = TIM_OCMODE_PWM1;
-    sConfigOC.Pulse = 60;
+    sConfigOC.OCMode = TIM_OCMODE_PWM2;
+    sConfigOC.Pulse = 10500;
     sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
     sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
     if (HAL_TIM_PWM_ConfigChannel(&htim2, &sConfigOC, TIM_CHANNEL_3) != HAL_OK)
@@ -337,36 +348,50 @@ static void MX_TIM3_Init (void)
 
     /* USER CODE END TIM3_Init 0 */
 
-    TIM_ClockConfigTypeDef sClockSourceConfig = { 0 };
+    TIM_SlaveConfigTypeDef sSlaveConfig = { 0 };
     TIM_MasterConfigTypeDef sMasterConfig = { 0 };
+    TIM_OC_InitTypeDef sConfigOC = { 0 };
 
     /* USER CODE BEGIN TIM3_Init 1 */
-    //Prescaler 2*X -1 tane pwm adımına denk gelir
-    //10500 2KHz
-    //16800 1.25 KHz
+    //TIM3, TIM2 nin TRGO suyla (update) sayar, her sayım bir step pulse udur
+    //Hareketin adım sayısı CCR1 e yazılır. OC1REF (PWM1, CNT < CCR1 iken high) TRGO dur ve TIM2 yi kapılar
     /* USER CODE END TIM3_Init 1 */
     htim3.Instance = TIM3;
-    htim3.Init.Prescaler = 10500;
+    htim3.Init.Prescaler = 0;
     htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-    htim3.Init.Period = 1;
+    htim3.Init.Period = 65535;
     htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
     htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
     if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
     {
         Error_Handler( );
     }
-    sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
-    if (HAL_TIM_ConfigClockSource(&htim3, &sClockSourceConfig) != HAL_OK)
+    if (HAL_TIM_PWM_Init(&htim3) != HAL_OK)
     {
         Error_Handler( );
     }
-    sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    sSlaveConfig.SlaveMode = TIM_SLAVEMODE_EXTERNAL1;
+    sSlaveConfig.InputTrigger = TIM_TS_ITR1;
+    if (HAL_TIM_SlaveConfigSynchro(&htim3, &sSlaveConfig) != HAL_OK)
+    {
+        Error_Handler( );
+    }
+    sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC1REF;
     sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
     if (HAL_TIMEx_MasterConfigSynchronization(&htim3, &sMasterConfig) != HAL_OK)
     {
         Error_Handler( );
     }
+    sConfigOC.OCMode = TIM_OCMODE_PWM1;
+    sConfigOC.Pulse = 0;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        Error_Handler( );
+    }
     /* USER CODE BEGIN TIM3_Init 2 */
+    __HAL_TIM_DISABLE_OCxPRELOAD(&htim3, TIM_CHANNEL_1);     //hareket sürerken CCR1 hemen geçerli olmalı
 
     /* USER CODE END TIM3_Init 2 */
 
@@ -488,6 +513,25 @@ static void MX_USART2_UART_Init (void)
 
 }
 
+/**
+ * Enable DMA controller clock
+ */
+static void MX_DMA_Init (void)
+{
+
+    /* DMA controller clock enable */
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    /* DMA interrupt init */
+    /* DMA1_Stream5_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
+    /* DMA1_Stream6_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+}
+
 /**
  * @brief GPIO Initialization Function
  * @param None
@@ -608,15 +652,7 @@ static void MX_GPIO_Init (void)
 void HAL_TIM_PeriodElapsedCallback (TIM_HandleTypeDef *htim)
 {
     taskDISABLE_INTERRUPTS();
-    if (htim->Instance == TIM3)
-    {
-        HAL_TIM_PWM_Stop(&htim2, TIM_CHANNEL_3);
-        HAL_TIM_Base_Stop(&htim2);
-        HAL_TIM_Base_Stop(&htim3);
-        HAL_GPIO_WritePin(STEER_PWM_GPIO_Port, STEER_PWM_Pin, GPIO_PIN_RESET);
-
-    }
-    else if (htim->Instance == TIM7)
+    if (htim->Instance == TIM7)
     {
 
         HAL_TIM_Base_Stop(&htim7);